@@ -0,0 +1,77 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef ASYNC_STREAM_WRITER_H
+#define ASYNC_STREAM_WRITER_H
+/*
+ *  async_stream_writer.hpp
+ *  hector
+ *
+ */
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Hector {
+
+/*! \brief Writes text to a stream from a background thread.
+ *
+ *  Text is appended to buffer() and handed to the writer thread by commit()
+ *  once the buffer is full, so the caller does not wait for the stream.  It
+ *  only waits if several full buffers are already queued (the stream cannot
+ *  keep up).  The thread is started when the first buffer is handed off.
+ *  Until flush() returns, the stream must not be used by anyone else.
+ */
+class AsyncStreamWriter {
+public:
+    AsyncStreamWriter( std::ostream& out, size_t bufferSize = 256 * 1024 );
+    ~AsyncStreamWriter();
+
+    //! The buffer to append text to
+    std::string& buffer() { return current; }
+
+    //! Hand the buffer to the writer thread if it is full
+    void commit() { if( current.size() >= bufferSize ) handOff(); }
+
+    void flush();
+
+private:
+    void handOff();
+    void writeLoop();
+
+    //! The stream written to
+    std::ostream& out;
+
+    //! Size at which buffers are handed off
+    const size_t bufferSize;
+
+    //! The buffer being filled
+    std::string current;
+
+    //! Buffers waiting to be written, and emptied ones for reuse
+    std::deque<std::string> pending;
+    std::vector<std::string> spare;
+
+    //! Whether the writer thread is writing a buffer
+    bool writing;
+
+    //! Whether the writer thread should stop once pending is empty
+    bool stopping;
+
+    std::mutex queueMutex;
+    std::condition_variable workReady;
+    std::condition_variable workDone;
+    std::thread writer;
+};
+
+}
+
+#endif // ASYNC_STREAM_WRITER_H
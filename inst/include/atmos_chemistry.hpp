@@ -0,0 +1,111 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef ATMOS_CHEMISTRY_HPP
+#define ATMOS_CHEMISTRY_HPP
+/*
+ *  atmos_chemistry.hpp
+ *  hector
+ *
+ */
+
+#include <vector>
+
+namespace Hector {
+
+class Core;
+class OHComponent;
+class CH4Component;
+class N2OComponent;
+class OzoneComponent;
+
+//------------------------------------------------------------------------------
+/*! \brief Fused atmospheric chemistry for the OH, CH4, N2O and ozone components.
+ *
+ *  When enabled (`fused_chemistry=1` in the OH section), the first of the
+ *  four components to run in a year advances all of them with a single
+ *  call to step(), which works on plain doubles.  The emissions and
+ *  concentration constraints the chemistry needs are gathered for the
+ *  rest of the run into a dense table, so a year costs a few flops instead
+ *  of a dozen messages and time series lookups.  The results are recorded
+ *  in the components' own time series, exactly as their run() methods
+ *  would record them, so their getData and output are unaffected.
+ *
+ *  The table is built at the first year after prepareToRun or reset.  If
+ *  one of the chemistry's inputs or parameters is set later, the
+ *  parameters are reloaded and the table is dropped until the next reset,
+ *  so inputs supplied one year at a time (e.g. by a coupled model) don't
+ *  rebuild it every year; inputs of other components leave it alone.
+ *  Years the table doesn't cover (e.g., missing emissions) gather their
+ *  inputs directly and so fail the same way the individual components
+ *  would.
+ */
+class AtmosChemistry {
+public:
+    AtmosChemistry();
+
+    static AtmosChemistry* find( Core* core );
+
+    void prepareToRun( Core* core );
+    void run( const double runToDate );
+    void reset( const double time );
+
+    //! Per-year inputs, one row per year
+    enum chem_input {
+        CI_NOX_OH, CI_CO_OH, CI_NMVOC_OH,       // OH component's emissions
+        CI_NOX_O3, CI_CO_O3, CI_NMVOC_O3,       // ozone component's emissions
+        CI_CH4_EMISS, CI_CH4_CONSTRAIN,         // CH4 emissions or constraint (NaN if none)
+        CI_N2O_EMISS, CI_N2O_CONSTRAIN,         // N2O total emissions or constraint (NaN if none)
+        N_CHEM_INPUTS
+    };
+
+    //! Values computed in one year
+    enum chem_output { CO_TAU_OH, CO_CH4, CO_N2O, CO_TAU_N2O, CO_O3, N_CHEM_OUTPUTS };
+
+    //! Parameters of the chemistry, without units
+    struct chem_params {
+        double M0_OH, TOH0, CCH4, CNOX, CCO, CNMVOC;    // OH lifetime
+        double NOX0, CO0, NMVOC0;                       // first year OH emissions
+        double UC_CH4, CH4N, Tsoil, Tstrat;             // CH4
+        double N0, UC_N2O, TN2O0;                       // N2O
+    };
+
+    static void step( const chem_params& p, const double in[],
+                      const double ch4, const double n2o, double out[] );
+
+private:
+    bool bind();
+    void gather( const double date, double in[] ) const;
+    void tabulate( const double from );
+    bool table_current();
+
+    Core* core;
+    OHComponent* oh;
+    CH4Component* ch4;
+    N2OComponent* n2o;
+    OzoneComponent* o3;
+
+    chem_params params;
+
+    //! Inputs from table_start on, N_CHEM_INPUTS per year
+    std::vector<double> table;
+    double table_start;
+    //! Core input version the table and parameters are current at
+    unsigned long table_version;
+    //! Inputs and parameters the table and parameters are read from
+    static const char *chem_inputs[];
+
+    //! State after the last year computed
+    double lastDate;
+    double ch4_prev, n2o_prev;
+
+    //! Components, parameters and state must be (re)loaded before the next run
+    bool stale;
+};
+
+}
+
+#endif // ATMOS_CHEMISTRY_HPP
@@ -0,0 +1,94 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef BINARY_IO_H
+#define BINARY_IO_H
+/*
+ *  binary_io.hpp
+ *  hector
+ *
+ */
+
+#include <istream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "h_exception.hpp"
+
+namespace Hector {
+
+/*! \brief Appends the fields of Hector's binary files (scenario bundles and
+ *         binary output) to a buffer.
+ *
+ *  Every such file starts with an 8-character magic string, a uint32 byte
+ *  order mark and a uint32 format version.  Fields are written in native
+ *  byte order; the byte order mark makes a file from another platform fail
+ *  to read rather than read wrongly.  Strings are a uint32 length followed
+ *  by their bytes.
+ */
+class BinaryWriter {
+public:
+    BinaryWriter( const char* magic, uint32_t version );
+
+    void put( const void* src, size_t n ) { buf.append( static_cast<const char*>( src ), n ); }
+    void put_u8( uint8_t x ) { buf.push_back( static_cast<char>( x ) ); }
+    void put_u32( uint32_t x ) { put( &x, sizeof( x ) ); }
+    void put_double( double x ) { put( &x, sizeof( x ) ); }
+    void put_string( const std::string& s );
+    void put_doubles( const std::vector<double>& x );
+
+    //! The bytes written so far
+    const std::string& data() const { return buf; }
+
+private:
+    std::string buf;
+};
+
+/*! \brief Reads the fields written by BinaryWriter from a stream, checking
+ *         them against the size of the file.
+ *
+ *  Every read (and every count, before anything is allocated for it) is
+ *  checked against the bytes left, so a truncated or corrupt file gives an
+ *  h_exception naming the file instead of a huge allocation or a short read.
+ */
+class BinaryReader {
+public:
+    BinaryReader( std::istream& in, std::streamoff size,
+                  const std::string& fileName, const std::string& what );
+
+    void read_header( const char* magic, uint32_t version );
+
+    void get( void* dest, size_t n );
+    uint8_t get_u8() { uint8_t x; get( &x, sizeof( x ) ); return x; }
+    uint32_t get_u32() { uint32_t x; get( &x, sizeof( x ) ); return x; }
+    double get_double() { double x; get( &x, sizeof( x ) ); return x; }
+    std::string get_string();
+    void get_doubles( std::vector<double>& x, uint32_t n );
+
+    void check( uint32_t n, size_t size ) const;
+
+    //! Bytes not yet read
+    std::streamoff left() const { return remaining; }
+
+    static bool has_magic( const std::string& fileName, const char* magic );
+
+    //! Length of the magic string at the start of each file
+    static const size_t magic_len = 8;
+
+private:
+    std::istream& in;
+    std::streamoff remaining;
+    //! The file name and kind of file, for errors
+    const std::string fileName;
+    const std::string what;
+
+    void truncated() const;
+};
+
+}
+
+#endif // BINARY_IO_H
@@ -0,0 +1,84 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef BINARY_OUTPUT_READER_H
+#define BINARY_OUTPUT_READER_H
+/*
+ *  binary_output_reader.hpp
+ *  hector
+ *
+ */
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "h_exception.hpp"
+
+namespace Hector {
+
+/*! \brief Reads files written by BinaryOutputVisitor.
+ *
+ *  Opening a file reads only its header (the variable dictionary and the
+ *  record dates).  Values are then read on demand by seeking straight to
+ *  them, so fetching one variable over a range of years reads just those
+ *  values, however large the file.
+ */
+class BinaryOutputReader {
+public:
+    BinaryOutputReader( const std::string& fileName );
+
+    //! Model version and run name the file was written with
+    const std::string& modelVersion() const { return model_version; }
+    const std::string& runName() const { return run_name; }
+
+    //! The variable dictionary
+    size_t nvariables() const { return names.size(); }
+    const std::string& component( size_t i ) const { return components.at( i ); }
+    const std::string& variable( size_t i ) const { return names.at( i ); }
+    const std::string& units( size_t i ) const { return var_units.at( i ); }
+    size_t findVariable( const std::string& component, const std::string& variable ) const;
+
+    //! The records (model periods)
+    size_t nrecords() const { return dates.size(); }
+    double date( size_t r ) const { return dates.at( r ); }
+    bool spinup( size_t r ) const { return spinup_flags.at( r ) != 0; }
+
+    void read( size_t var, double startDate, double endDate,
+               std::vector<double>& outDates, std::vector<double>& values,
+               bool inSpinup = false );
+
+    void readRecord( size_t r, std::vector<double>& values );
+
+private:
+    //! Read the value at a position in the data
+    double readValue( size_t r, size_t var );
+
+    //! The file name, for errors
+    const std::string fileName;
+
+    //! The open file
+    std::ifstream in;
+
+    std::string model_version;
+    std::string run_name;
+
+    //! Dictionary: component, name and units of each variable
+    std::vector<std::string> components;
+    std::vector<std::string> names;
+    std::vector<std::string> var_units;
+
+    //! Date and spinup flag of each record
+    std::vector<double> dates;
+    std::vector<char> spinup_flags;
+
+    //! Offset of the first record in the file
+    std::streamoff dataStart;
+};
+
+}
+
+#endif // BINARY_OUTPUT_READER_H
@@ -0,0 +1,52 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef BINARY_OUTPUT_VISITOR_H
+#define BINARY_OUTPUT_VISITOR_H
+/*
+ *  binary_output_visitor.hpp
+ *  hector
+ *
+ */
+
+#include <string>
+
+#include "recording_output_visitor.hpp"
+
+namespace Hector {
+
+/*! \brief A visitor which writes the results recorded by
+ *         RecordingOutputVisitor to a compact, self-describing binary file.
+ *
+ *  Each value is stored once, as a raw double, instead of as a line of text
+ *  repeating the date, run name, component and units.  The file is written
+ *  by close() and read with BinaryOutputReader.
+ *
+ *  File layout (native byte order, checked on reading): the magic string
+ *  "HECTORBO", a uint32 byte order mark, a uint32 format version, the model
+ *  version and run name, then the dictionary: a uint32 count and, for each
+ *  variable, its component, name and units.  Strings are a uint32 length
+ *  followed by their bytes.  Next come a uint32 record count, the date of
+ *  every record (doubles) and its spinup flag (uint8).  The rest of the file
+ *  is one record per model period, each holding a double for every variable
+ *  in dictionary order; values not written in that period are NaN.  Every
+ *  record has the same size, so a value can be read by seeking straight to it.
+ */
+class BinaryOutputVisitor : public RecordingOutputVisitor {
+public:
+    BinaryOutputVisitor( const std::string& fileName );
+    ~BinaryOutputVisitor();
+
+    //! Current version of the file format
+    static const unsigned int version = 1;
+
+protected:
+    virtual void write();
+};
+
+}
+
+#endif // BINARY_OUTPUT_VISITOR_H
@@ -100,6 +100,38 @@ public:
     //! method, which does nothing.
     virtual void record_state(double t) {}
 
+    //! Whether atmospheric CO2 is prescribed (constrained) at time t
+    virtual bool atmosphere_prescribed(double t) const { return false; }
+
+    //! Set the atmosphere to its prescribed value in place of a time step
+
+    //! \details Called by the solver instead of integrating when the
+    //! core is running concentration-driven and atmosphere_prescribed(t)
+    //! is true.  The model should set atmospheric CO2 from its
+    //! constraint for time t, leaving the other pools as they are, and
+    //! record the state as record_state would.
+    virtual void prescribe_atmosphere(double t) {
+        H_THROW("Concentration-driven runs are not supported by " + getComponentName())
+    }
+
+    //! Number of state variables that evolve during spinup
+
+    //! \details The solver's accelerated spinup treats one year of
+    //! spinup as a map x -> G(x) on these variables and extrapolates
+    //! toward its fixed point.  The state must include everything
+    //! that drifts during spinup, including state that is not carried
+    //! in the solver's pool array (e.g. individual ocean boxes), and
+    //! every linear combination of states with weights summing to one
+    //! must conserve mass.  The default of zero means the model does
+    //! not support accelerated spinup.
+    virtual int nspinupstate() const { return 0; }
+
+    //! Copy the spinup state variables into x
+    virtual void getSpinupState( double x[] ) const {}
+
+    //! Set the spinup state variables from x
+    virtual void setSpinupState( const double x[] ) {}
+
     // Create, delete, and rename biomes. These must be defined here
     // because some C cycle models (e.g. the ocean C cycle component)
     // will not have biomes, but are members of the `CarbonCycleModel`
@@ -120,11 +152,11 @@ public:
 
 protected:
     //! Number of carbon pools in the model.
-    //! \details nc must be constant over the life of the calculation.
-    //! Often it will be known from the moment the model is
-    //! instantiated, but we leave open the possibility that it might be
-    //! affected by some user settable parameters (e.g. number of deep
-    //! ocean boxes).
+    //! \details nc must be constant over the life of a single solver
+    //! run.  Often it will be known from the moment the model is
+    //! instantiated, but it may be affected by some user settable
+    //! parameters (e.g. number of deep ocean boxes or land biomes), so
+    //! the solver re-reads it at the start of each run.
     int nc;
 
     // Time
@@ -15,6 +15,7 @@
  */
 
 #include <string>
+#include <deque>
 
 #include "logger.hpp"
 #include "carbon-cycle-model.hpp"
@@ -100,6 +101,7 @@ private:
     double dt;
     
     unitval eps_spinup;     //! spinup epsilon (drift/tolerance), Pg C
+    int spinup_accel;       //! spinup acceleration depth (0 = plain time stepping)
     
     struct bad_derivative_exception {
         bad_derivative_exception(const int status):errorFlag(status) { }
@@ -115,6 +117,14 @@ private:
     };
     
     void failure( int stat, double t0, double tmid );
+
+    bool accelerate_spinup();
+
+    //! The error-controlled ODE stepper.  It is kept between runs so that
+    //! its work space is allocated once, not every time step; it is
+    //! rebuilt when the number of pools or the tolerances change.
+    struct ControlledStepper;
+    ControlledStepper *stepper;
     
     bool in_spinup;
     
@@ -130,6 +140,15 @@ private:
     std::vector<double> c_old;
     std::vector<double> c_new;
     std::vector<double> dcdt;
+
+    //! Accelerated spinup working space: the state at the start of the
+    //! current spinup year (x), its image after one year (g), and the
+    //! recent differences of images and residuals (g-x)
+    std::vector<double> spinup_x;
+    std::vector<double> spinup_g;
+    std::vector<double> spinup_f;
+    std::deque<std::vector<double> > spinup_dg;
+    std::deque<std::vector<double> > spinup_df;
 };
 
 }
@@ -19,6 +19,7 @@
 #include "logger.hpp"
 #include "tseries.hpp"
 #include "unitval.hpp"
+#include "atmos_chemistry.hpp"
 
 namespace Hector {
 
@@ -26,6 +27,7 @@ namespace Hector {
 /*! \brief Methane model component.
  */
 class CH4Component : public IModelComponent {
+    friend class AtmosChemistry;
 
 public:
     CH4Component();
@@ -67,6 +69,9 @@ public:
     unitval Tsoil;  // annual CH4 loss to soil, Tg CH4/yr
     unitval Tstrat; //  annual CH4 loss to stratosphere, Tg CH4/yr
 
+    //! Fused chemistry that runs this component, if enabled
+    AtmosChemistry* chemistry;
+
     // logger
     Logger logger;
 
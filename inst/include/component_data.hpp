@@ -25,8 +25,10 @@
 #define D_END_DATE              "endDate"
 #define D_DO_SPINUP             "do_spinup"
 #define D_MAX_SPINUP            "max_spinup"
+#define D_CONC_DRIVEN           "concentration_driven"
 #define D_ENABLED               "enabled"
 #define D_OUTPUT_ENABLED        "output"
+#define D_OUTPUT_VARIABLES      "output_variables"
 
 // bc component
 #define D_EMISSIONS_BC          "BC_emissions"
@@ -36,6 +38,7 @@
 #define D_CCS_EPS_REL           "eps_rel"
 #define D_CCS_DT                "dt"
 #define D_EPS_SPINUP            "eps_spinup"
+#define D_SPINUP_ACCEL          "spinup_accel"
 
 // forcing component
 #define D_RF_PREFIX             "F"
@@ -208,6 +211,7 @@
 #define D_COEFFICENT_CH4        "CCH4"
 #define D_COEFFICENT_NMVOC      "CNMVOC"
 #define D_COEFFICENT_CO         "CCO"
+#define D_FUSED_CHEMISTRY       "fused_chemistry"
 
 //o3 component
 #define D_PREINDUSTRIAL_O3	      "PO3"
@@ -291,6 +295,7 @@
 #define D_BETA                  "beta"
 //#define D_SIGMA                 "sigma"
 #define D_WARMINGFACTOR         "warmingfactor"
+#define D_LAND_CELLS            "land_cells"
 
 // slr component
 #define D_SL_RC                 "sl_rc"
@@ -312,6 +317,7 @@
 #define D_OCEAN_AIR_TEMP        "Tgav_ocean_air"
 #define D_GLOBAL_TEMPEQ         "Tgaveq"
 #define D_TGAV_CONSTRAIN        "tgav_constrain"
+#define D_TEMP_PATTERN          "pattern"
 #define D_SO2D_B                "so2d_b"
 #define D_SO2I_B                "so2i_b"
 #define D_OC_B                  "oc_b"
@@ -30,9 +30,12 @@
 #define OCEAN_COMPONENT_NAME "ocean"
 
 /***
- * The name of a HC component is X_COMPONENT_BASE + HALOCARBON_EXTENSION
+ * All halocarbons are run by one component, HALOCARBON_COMPONENT_NAME.
+ * Each one is still addressed (e.g., as an input file section) by the alias
+ * X_COMPONENT_BASE + HALOCARBON_EXTENSION
  * The name of a HC emissions var is X_COMPONENT_BASE + EMISSIONS_EXTENSION
  ***/
+#define HALOCARBON_COMPONENT_NAME "halocarbons"
 #define HALOCARBON_EXTENSION "_halocarbon"
 #define EMISSIONS_EXTENSION  "_emissions"
 #define CONCENTRATION_EXTENSION  "_concentration"
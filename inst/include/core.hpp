@@ -28,6 +28,7 @@ namespace Hector {
 class unitval;
 struct message_data;
 class IModelComponent;
+class ResultsCollectorVisitor;
 
 //------------------------------------------------------------------------------
 /*! \brief Core class.
@@ -48,6 +49,10 @@ public:
 
     void addVisitor( AVisitor* visitor );
 
+    ResultsCollectorVisitor* collectResults( const std::vector<std::string>& vars );
+    //! The results stored by collectResults (null if it has not been called)
+    const ResultsCollectorVisitor* getResults() const { return resultsCollector; }
+
     void prepareToRun();
 
     void run(double runtodate=-1.0);
@@ -68,6 +73,7 @@ public:
 
     void registerDependency( const std::string& capabilityName, const std::string& componentName );
     void registerInput(const std::string &inputName, const std::string &componentName);
+    void registerComponentAlias( const std::string& alias, const std::string& componentName );
 
     unitval sendMessage( const std::string& message,
                         const std::string& datum );
@@ -81,10 +87,19 @@ public:
     double getCurrentDate() const {return lastDate;}
     std::string getRun_name() const { return run_name; };
     bool inSpinup() const { return in_spinup; };
+    bool concentrationDriven() const { return conc_driven; }
+    bool componentEnabled( const std::string& componentName ) const { return std::find( disabledComponents.begin(),
+                disabledComponents.end(), componentName) == disabledComponents.end(); }
     bool outputEnabled( std::string componentName ) { return std::find( disabledOutputComponents.begin(),
                 disabledOutputComponents.end(), componentName) == disabledOutputComponents.end(); }
+    //! Variables the output visitors should write; empty for all of them
+    const std::vector<std::string>& getOutputVariables() const { return outputVariables; }
     void addModelComponent( IModelComponent* modelComponent );
 
+    //! Number of times any input has been set
+    unsigned long getInputVersion() const { return inputVersion; }
+    unsigned long getInputVersion( const std::string& inputName ) const;
+
     // IVisitable methods
     virtual void accept( AVisitor* visitor );
 
@@ -124,6 +139,9 @@ private:
     //! Cause all components to run their spinup procedure.
     bool run_spinup();
 
+    //! Is a spinup required for this run?
+    bool spinupNeeded();
+
 
     //------------------------------------------------------------------------------
     //! Current run name.
@@ -149,6 +167,11 @@ private:
     //! A flag (can be set from input) to indicate whether to spin up.
     bool do_spinup;
 
+    //------------------------------------------------------------------------------
+    //! A flag (can be set from input) to read atmospheric CO2 from its
+    //! constraint instead of running the carbon cycle.
+    bool conc_driven;
+
     //------------------------------------------------------------------------------
     //! Maximum number of spinup steps allowed.
     int max_spinup;
@@ -190,6 +213,9 @@ private:
     // A map of component capabilities (as reported by the components).
     std::multimap<std::string, std::string> componentCapabilities;
 
+    // Other names for model components (alias -> component name)
+    std::map<std::string, std::string> componentAliases;
+
     // A map of component dependencies (depending on CAPABILITY, not component name).
     std::multimap<std::string, std::string> componentDependencies;
 
@@ -200,6 +226,14 @@ private:
     // into the model (e.g., emissions).
     std::multimap<std::string, std::string> componentInputs;
 
+    // Count of input changes, and the count at which each input (by
+    // variable name, without any biome prefix) was last set.  Components
+    // that cache values derived from their inputs compare these to tell
+    // whether the cache is still current.
+    unsigned long inputVersion;
+    std::map<std::string, unsigned long> inputVersions;
+    void bumpInputVersion( const std::string& inputName );
+
     // A list of components that have been disabled
     // When a component is disabled, it still receives input data
     // But its capabilities aren't honored, and it won't be called
@@ -208,6 +242,9 @@ private:
     // A list of components whose output has been disabled
     std::vector<std::string> disabledOutputComponents;
 
+    // The variables to output (see OutputSubscription); empty for all
+    std::vector<std::string> outputVariables;
+
     // Some helpful typedefs to clean up syntax
     typedef std::multimap<std::string, std::string>::iterator componentMapIterator;
     typedef std::map<std::string, IModelComponent*,
@@ -223,6 +260,9 @@ private:
     std::vector<AVisitor*> modelVisitors;
     // Some helpful typedefs to clean up syntax
     typedef std::vector<AVisitor*>::iterator VisitorIterator;
+
+    //! Visitor storing selected results, owned by the core
+    ResultsCollectorVisitor* resultsCollector;
 };
 
 }
@@ -15,60 +15,53 @@
  */
 
 #include <string>
+#include <vector>
 
-#include "avisitor.hpp"
+#include "async_stream_writer.hpp"
+#include "output_catalog_visitor.hpp"
+#include "unitval.hpp"
 
 #define DELIMITER ","
 
 namespace Hector {
 
 /*! \brief A visitor which will report all results at each model period.
+ *
+ *  Lines are formatted into a buffer on the model thread and written to the
+ *  stream by a background thread (see AsyncStreamWriter), so the stream holds
+ *  the complete output only after flush() or destruction.  The variables
+ *  written are those of OutputCatalogVisitor.
  */
-class CSVOutputStreamVisitor : public AVisitor {
+class CSVOutputStreamVisitor : public OutputCatalogVisitor {
 public:
     CSVOutputStreamVisitor( std::ostream& outputStream, const bool printHeader = true );
     ~CSVOutputStreamVisitor();
 
-    virtual bool shouldVisit( const bool in_spinup, const double date );
-
     virtual void visit( Core* c );
     virtual void visit( ForcingComponent* c );
-    virtual void visit( SimpleNbox* c );
-    virtual void visit( HalocarbonComponent* c );
-    virtual void visit( TemperatureComponent* c );
     virtual void visit( BlackCarbonComponent* c );
     virtual void visit( OrganicCarbonComponent* c );
-    virtual void visit( slrComponent* c );
-    virtual void visit( OceanComponent* c );
-    virtual void visit( OzoneComponent* c );
-    virtual void visit( OHComponent* c );
-    virtual void visit( CH4Component* c );
-	virtual void visit( N2OComponent* c );
-
-private:
-    //! The file output stream in which the csv output will be written to.
-    std::ostream& csvFile;
-
-    // Data retained while the visitor is operating
-    double current_date;
 
-    // Spin up Flag
-    bool in_spinup;
+    void flush();
 
-    //! Current model date, stored as a string for output
-    std::string datestring;
+protected:
+    virtual void output( const std::string& component, const std::string& name,
+                         const unitval& x );
+    virtual void output( const std::string& component, const std::string& name,
+                         const unitval& x, double date );
 
-    //! Current model mode, stored as a string for output
-    std::string spinupstring;
+private:
+    //! Formats lines into buffers that a background thread writes to the stream
+    AsyncStreamWriter writer;
 
-    //! Name of current run
-    std::string run_name;
+    //! Precision of output values, as the stream's precision()
+    int precision;
 
-    //! Helper function: prints beginning of each output line
-    std::string linestamp() ;
+    //! Text that starts every output line for the current period
+    std::string stamp;
 
-    //! pointers to other components and stuff
-    Core*             core;
+    //! Helper function: text that starts each output line for a date
+    std::string linestamp( double date ) const;
 };
 
 }
@@ -15,12 +15,19 @@
  */
 
 #include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 #include "h_exception.hpp"
+#include "unitval.hpp"
 
 namespace Hector {
 
 class Core;
+class ScenarioBundle;
 
 /*! \brief A class responsible for reading time series data from a CSV file and
  *         routing this data through the core.
@@ -35,30 +42,140 @@ class Core;
  *
  *  When instructed to process the class requires routing information including
  *  the variable to set so that it can identify which column to process.  It will
- *  then route data as each row is read.  Note that the file will remain open
- *  and available for reprocessing until it is destructed.
+ *  then route data from each row of that column.  Tables are parsed once per
+ *  process into a shared cache keyed by file name, so an input file referenced
+ *  by many INI keys (e.g. an emissions table) is only read the first time; the
+ *  cached table is re-read if the file's size, modification or change time
+ *  (in nanoseconds) or inode changes.  A file modified within a couple of
+ *  seconds of being read could change again without its times changing, so
+ *  its contents are compared until it is older.  The cache keeps the most
+ *  recently used tables, up to max_cached_tables.
+ *  All the tables an INI file needs can be loaded concurrently beforehand
+ *  with preload.
+ *  Parsing only locates the cells; each column is converted to numbers the
+ *  first time it is requested, and its values are sent to the components as
+ *  unitvals so they need not be parsed again.
+ *
+ *  Tables whose rows are named rather than dated (e.g. one row per land cell)
+ *  are read with getRowNames, getColumnNames and getValues instead.  The
+ *  contents of such a table may also be given directly (e.g. from a scenario
+ *  bundle), in which case the file name is only used in messages and the
+ *  table is not cached.
  */
 class CSVTableReader {
 public:
-    CSVTableReader( const std::string& fileName );
+    CSVTableReader( const std::string& fileName,
+                    std::shared_ptr<const std::string> contents = std::shared_ptr<const std::string>() );
     ~CSVTableReader();
 
     void process( Core* core, const std::string& componentName,
                   const std::string& varName );
 
+    void record( ScenarioBundle& bundle, const std::string& componentName,
+                 const std::string& varName );
+
+    std::vector<std::string> getRowNames();
+
+    std::vector<std::string> getColumnNames();
+
+    std::vector<unitval> getValues( const std::string& varName );
+
+    static void clearCache();
+
+    static void preload( const std::vector<std::string>& fileNames );
+
 private:
+    /*! \brief A parsed CSV table
+     *
+     *  The file is held in memory with the position of every cell, by row.
+     *  Columns are converted to numbers on demand.
+     */
+    struct csv_table {
+        //! Contents of the file
+        std::string text;
+        //! Header line, kept for error reporting
+        std::string header;
+        //! Column names; the first is the index column
+        std::vector<std::string> colnames;
+        //! Number of columns (including the index)
+        size_t ncol;
+        //! Line number of each row, for error reporting
+        std::vector<int> lines;
+        //! Whether each row is a UNITS row
+        std::vector<bool> units_row;
+        //! Index (date) of each row; unused for UNITS rows
+        std::vector<double> index;
+        //! Line number of the first data row whose index is not a number, or
+        //! 0 if there is none; an error only for time series
+        int bad_index_line;
+        //! Start and end offsets into text of each cell, ncol per row; both
+        //! are zero for cells missing from short rows
+        std::vector<std::pair<size_t, size_t> > cells;
+
+        //! A column converted to values
+        struct column {
+            //! Units of each row's value
+            std::vector<std::string> units;
+            //! Values by row
+            std::vector<double> values;
+            //! Whether each row's cell is blank (or a UNITS row)
+            std::vector<bool> blank;
+        };
+        //! Converted columns, by column number
+        mutable std::map<size_t, std::shared_ptr<const column> > columns;
+        //! Guards columns
+        mutable std::mutex columnsMutex;
+
+        std::shared_ptr<const column> getColumn( size_t col,
+                                                 const std::string& fileName ) const;
+    };
+
+    //! What a file looked like when it was read
+    struct file_stamp {
+        long long size;
+        long long mtime_ns;
+        long long ctime_ns;
+        long long inode;
+        bool operator==( const file_stamp& other ) const {
+            return size == other.size && mtime_ns == other.mtime_ns
+                && ctime_ns == other.ctime_ns && inode == other.inode;
+        }
+    };
+
+    //! A cached table and the file stamp it was read with
+    struct cache_entry {
+        file_stamp stamp;
+        //! Whether the file was recently modified, so the stamp may not
+        //! show a further change
+        bool racy;
+        //! When the table was last used, by cacheClock
+        unsigned long lastUse;
+        std::shared_ptr<const csv_table> table;
+    };
+
     //! The file name to read data from.  Kept around for error reporting.
     const std::string fileName;
 
-    //! Input stream to read data from.
-    std::ifstream tableInputStream;
+    //! The table's contents, if given rather than read from the file
+    const std::shared_ptr<const std::string> contents;
+
+    //! The table parsed from contents
+    std::shared_ptr<const csv_table> contentsTable;
 
-    //! Current line (that has just been read)
-    int lineNum;
+    std::shared_ptr<const csv_table> getTable();
+    size_t findColumn( const csv_table& table, const std::string& varName ) const;
+    void checkIndex( const csv_table& table ) const;
+    file_stamp stampFile() const;
+    void readFile( std::string& text ) const;
+    std::shared_ptr<const csv_table> parseTable();
 
-    // Helper function to find next non-commented line
-    std::string csv_getline();
+    //! Most tables kept in the cache
+    static const size_t max_cached_tables = 64;
 
+    //! Tables read so far, by file name
+    static std::map<std::string, cache_entry> tableCache;
+    static unsigned long cacheClock;
+    static std::mutex tableCacheMutex;
 };
 
 }
@@ -14,9 +14,11 @@
  *
  */
 
+#include <bitset>
+#include <vector>
+
 #include "imodel_component.hpp"
 #include "tseries.hpp"
-#include "tvector.hpp"
 
 namespace Hector {
 
@@ -31,6 +33,7 @@ class HalocarbonComponent;
  */
 class ForcingComponent : public IModelComponent {
     friend class CSVOutputStreamVisitor;
+    friend class OutputCatalogVisitor;
 public:
 
     ForcingComponent();
@@ -59,18 +62,52 @@ public:
     //! IVisitable methods
     virtual void accept( AVisitor* visitor );
 
-    //! A list (map) of all computed forcings, with associated iterator
-    typedef std::map<std::string, unitval > forcings_t;
-    typedef std::map<std::string, unitval >::iterator forcingsIterator;
+    //! Forcing agents, which index the per-year forcing arrays.
+    //! Halocarbon i (in the order of adjusted_halo_forcings) is FA_HALO + i.
+    enum forcing_agent {
+        FA_HALO = 0,
+        FA_CO2 = FA_HALO + N_HALO_FORCINGS,
+        FA_CH4,
+        FA_N2O,
+        FA_H2O_STRAT,
+        FA_O3_TROP,
+        FA_BC,
+        FA_OC,
+        FA_SO2D,
+        FA_SO2I,
+        FA_VOL,
+        FA_T_ALBEDO,
+        FA_TOTAL,               //!< total of all the agents above (or the user constraint)
+        N_FORCING_AGENTS
+    };
 
 private:
     virtual unitval getData( const std::string& varName,
                             const double valueIndex );
 
-    //! Base year forcings
-    forcings_t baseyear_forcings;
-    //! Forcings by year
-    tvector<forcings_t> forcings_ts;
+    //! Forcings (W/m2, relative to the base year) recorded for date
+    const double* forcings_at( const double date ) const;
+
+    void exogenous_forcings( const double date, double forcings[],
+                             std::bitset<N_FORCING_AGENTS>& present );
+    void precompute_exogenous();
+    bool exogenous_current();
+
+    //! Base year forcings, W/m2
+    double baseyear_forcings[ N_FORCING_AGENTS ];
+    //! Forcings by year: one row of N_FORCING_AGENTS per year, starting at baseyear
+    std::vector<double> forcings_ts;
+    //! Agents that are computed in this run (the others are not in forcings_ts)
+    std::bitset<N_FORCING_AGENTS> agent_present;
+
+    // Forcings that depend only on input time series (black and organic
+    // carbon, SO2, volcanic, albedo) are evaluated for the whole run ahead
+    // of time, and recomputed only after one of their inputs is set.
+    std::vector<double> exogenous_ts;       //!< absolute exogenous forcings, rows as in forcings_ts
+    std::bitset<N_FORCING_AGENTS> exogenous_present; //!< agents in exogenous_ts
+    unsigned long exogenous_version;        //!< core input version exogenous_ts was computed at
+    bool exogenous_stale;                   //!< recompute exogenous_ts at the next run?
+    static const char *exogenous_inputs[];  //!< inputs the exogenous forcings depend on
 
     double baseyear;        //! Year which forcing calculations will start
     double currentYear;     //! Tracks current year
@@ -82,8 +119,8 @@ private:
     Logger logger;          //! Logger
 
     static const char *adjusted_halo_forcings[]; //! Capability strings for halocarbon forcings
-    static const char *halo_forcing_names[];  //! Internal names of halocarbon forcings
-    static std::map<std::string, std::string> forcing_name_map;
+    static const char *forcing_names[];         //! Variable name of each forcing agent
+    static const std::map<std::string, int>& agent_index(); //! Forcing agent of each variable name
 };
 
 }
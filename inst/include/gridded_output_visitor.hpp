@@ -0,0 +1,54 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef GRIDDED_OUTPUT_VISITOR_H
+#define GRIDDED_OUTPUT_VISITOR_H
+/*
+ *  gridded_output_visitor.hpp
+ *  hector
+ *
+ */
+
+#include <fstream>
+#include <string>
+
+#include "avisitor.hpp"
+
+namespace Hector {
+
+/*! \brief A visitor which writes the pattern-scaled temperature grid at each
+ *         model period.
+ *
+ *  Nothing is written (and the file is not created) unless the temperature
+ *  component was given a pattern.  The file is binary, in native byte order:
+ *  the four bytes `HGRD`, the number of cells as a 32-bit integer, the
+ *  latitude and then the longitude of every cell as 32-bit floats, and then
+ *  for each date the date as a 64-bit float followed by the temperature
+ *  anomaly of every cell as 32-bit floats.
+ */
+class GriddedOutputVisitor : public AVisitor {
+public:
+    GriddedOutputVisitor( const std::string& fileName );
+    ~GriddedOutputVisitor();
+
+    virtual bool shouldVisit( const bool in_spinup, const double date );
+
+    virtual void visit( TemperatureComponent* c );
+
+private:
+    //! The file to write to, opened on the first visit with a pattern.
+    const std::string fileName;
+
+    //! The binary output stream
+    std::ofstream gridFile;
+
+    //! Current model date
+    double current_date;
+};
+
+}
+
+#endif // GRIDDED_OUTPUT_VISITOR_H
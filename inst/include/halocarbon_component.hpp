@@ -14,6 +14,9 @@
  *
  */
 
+#include <map>
+#include <vector>
+
 #include "logger.hpp"
 #include "tseries.hpp"
 #include "unitval.hpp"
@@ -22,17 +25,25 @@
 namespace Hector {
 
 //------------------------------------------------------------------------------
-/*! \brief Model component for a halocarbon.
+/*! \brief Model component for the halocarbons.
  *
- *  A halocarbon model component that simply decays in the atmosphere.  Adapted
- *  from Bill Emanuel's python implementation.
+ *  Halocarbons that simply decay in the atmosphere.  Adapted from Bill
+ *  Emanuel's python implementation.
  *
+ *  All gases are run together, their parameters and state held as parallel
+ *  arrays indexed by gas.  Each gas keeps its own component name
+ *  (`<gas>_halocarbon`) as an alias, so input file sections, per-gas
+ *  `enabled` and `output` switches, and the per-gas capabilities and inputs
+ *  (`F<gas>`, `<gas>_concentration`, `<gas>_emissions`, `<gas>_constrain`)
+ *  work as if each gas were a component of its own.  The core passes
+ *  settings for a gas as `<gas>_halocarbon.<variable>`.
  */
 class HalocarbonComponent : public IModelComponent {
     friend class CSVOutputStreamVisitor;
+    friend class OutputCatalogVisitor;
 
 public:
-    HalocarbonComponent( std::string g );
+    HalocarbonComponent();
     virtual ~HalocarbonComponent();
 
 
@@ -63,24 +74,55 @@ private:
     virtual unitval getData( const std::string& varName,
                             const double valueIndex );
 
-    //! Who are we?
-    std::string myGasName;
+    //! Per-gas variables that can be addressed by name
+    enum gas_var { HC_FORCING, HC_CONCENTRATION, HC_CONSTRAIN, HC_EMISSIONS };
+    int parse_gas( const std::string& varName, std::string& var ) const;
+    size_t nrow() const { return conc_ts.size() / ngas; }
+
+    //! Names of the gases
+    static const char *gas_names[];
+
+    //! Number of gases
+    const int ngas;
+
+    //! Component name (alias) of each gas
+    std::vector<std::string> gas_component;
+
+    //! Gas (and variable) for each per-gas variable name, e.g. CF4_emissions
+    std::map<std::string, std::pair<int, gas_var> > gas_vars;
+
+    //! Gas for each alias
+    std::map<std::string, int> gas_aliases;
+
+    //! Is the gas enabled?
+    std::vector<bool> enabled;
+
+    //! Lifetime of each gas [years]
+    std::vector<double> tau;
+
+    //! Radiative forcing efficiency of each gas [W/m^2/pptv]
+    std::vector<double> rho;
+
+    //! Molar mass of each gas [g/mol]
+    std::vector<double> molarMass;
 
-    //! Rate coefficient of loss [relates to year?]
-    double tau;
+    //! Preindustrial concentration of each gas [pptv]
+    std::vector<double> H0;
 
-    //! Radiative forcing efficiency [W/m^2/pptv]
-    unitval rho;
+    //! One-year decay factor of each gas, exp(-1/tau)
+    std::vector<double> decay;
 
-    //! Forcing [W/m^2]
-    tseries<unitval> hc_forcing;
+    std::vector<tseries<unitval> > emissions;       //! Time series of emissions of each gas
+    std::vector<tseries<unitval> > Ha_constrain;    //! Concentration constraint of each gas, pptv
 
-    tseries<unitval> emissions;     //! Time series of emissions, pptv
-    tseries<unitval> Ha_ts;         //! Time series of (ambient) concentration, pptv
-    tseries<unitval> Ha_constrain; //! Concentration constraint, pptv
-    unitval H0;                     //! Preindustrial concentration, pptv
+    //! Concentrations [pptv] and forcings [W/m^2] by year: one row of ngas
+    //! values per year, starting at the model start date
+    std::vector<double> conc_ts;
+    std::vector<double> forcing_ts;
 
-    double molarMass;
+    //! Scratch space for the emissions in one year, molar (pptv)
+    std::vector<double> emiss;
+    std::vector<bool> constrained;
 
     //! logger
     Logger logger;
@@ -33,9 +33,16 @@
 
 /* Setup functions */
 #include "ini_to_core_reader.hpp"
+#include "scenario_bundle.hpp"
 
 /* Output functions */
 #include "csv_outputstream_visitor.hpp"
+#include "recording_output_visitor.hpp"
+#include "binary_output_visitor.hpp"
+#include "wide_csv_output_visitor.hpp"
+#include "binary_output_reader.hpp"
+#include "results_collector_visitor.hpp"
+#include "output_subscription.hpp"
 
 
 #endif
@@ -14,11 +14,16 @@
  *
  */
 
+#include <map>
+#include <string>
+#include <vector>
+
 #include "h_exception.hpp"
 
 namespace Hector {
 
 class Core;
+class ScenarioBundle;
 
 /*! \brief An adaptor class to send data read from an INI file directly to the
  *         core for routing to the proper model subcomponent.
@@ -38,21 +43,43 @@ class INIToCoreReader {
 
     void parse( const std::string& filename );
 
+    void record( const std::string& filename, ScenarioBundle& scenario );
+
     private:
     //! Weak reference to a Core object that will handle parsed values
     Core* core;
 
+    //! Bundle to record values in instead of routing them, when recording
+    ScenarioBundle* bundle;
+
+    void parseINI( const std::string& filename );
+
     //! Path of the INI file
     std::string iniFilePath;
 
+    //! Canonical directory of the INI file, found when first needed
+    std::string iniDirectory;
+
     //! The exception set by value handler should an exception occur.
     //! Note that this would only be valid if valueHandler returned
     //! an error code.
     h_exception valueHandlerException;
 
+    //! Time series tables referred to by the INI file, collected by
+    //! fileNameHandler
+    std::vector<std::string> csvFileNames;
+
     static int valueHandler( void* user, const char* section, const char* name,
                              const char* value);
 
+    static int fileNameHandler( void* user, const char* section, const char* name,
+                                const char* value );
+
+    //! File names already resolved by resolveFileName
+    std::map<std::string, std::string> resolvedFileNames;
+
+    std::string resolveFileName( std::string csvFileName );
+
     typedef std::string::const_iterator StringIter;
     static double parseTSeriesIndex( const StringIter startBracket,
                                      const StringIter endBracket,
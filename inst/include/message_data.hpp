@@ -14,6 +14,7 @@
  *
  */
 
+#include <memory>
 #include <string>
 
 #include "core.hpp"
@@ -89,6 +90,10 @@ struct message_data {
 
     //! Flag indicating whether the unitval is set
     bool isVal;
+
+    //! (optional) Contents of the file named by value_str, for a table that
+    //! is not to be read from disk (e.g. one embedded in a scenario bundle).
+    std::shared_ptr<const std::string> file_contents;
 };
 
 }
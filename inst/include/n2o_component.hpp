@@ -18,6 +18,7 @@
 #include "logger.hpp"
 #include "tseries.hpp"
 #include "unitval.hpp"
+#include "atmos_chemistry.hpp"
 
 namespace Hector {
 
@@ -27,6 +28,7 @@ namespace Hector {
  *  This doesn't do much yet.
  */
 class N2OComponent : public IModelComponent {
+    friend class AtmosChemistry;
 
 public:
     N2OComponent();
@@ -68,6 +70,9 @@ private:
     tseries<unitval> TAU_N2O;   //! N2O decay time constant (varies as a function of concentration)
     unitval TN2O0;  //! inital N2O lifetime, years
 
+    //! Fused chemistry that runs this component, if enabled
+    AtmosChemistry* chemistry;
+
     //! logger
     Logger logger;
 
@@ -18,6 +18,7 @@
 #include "logger.hpp"
 #include "tseries.hpp"
 #include "unitval.hpp"
+#include "atmos_chemistry.hpp"
 
 namespace Hector {
 //------------------------------------------------------------------------------
@@ -26,6 +27,7 @@ namespace Hector {
  *  This doesn't do much yet.
  */
 class OzoneComponent : public IModelComponent {
+    friend class AtmosChemistry;
 
 public:
     OzoneComponent();
@@ -66,6 +68,9 @@ private:
     tseries<unitval> NMVOC_emissions;
     tseries<unitval> NOX_emissions;
 
+    //! Fused chemistry that runs this component, if enabled
+    AtmosChemistry* chemistry;
+
     //! logger
     Logger logger;
 
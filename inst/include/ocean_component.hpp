@@ -74,6 +74,9 @@ public:
     void slowparameval( double t, const double c[] );
     void stashCValues( double t, const double c[] );
     void record_state(double t);
+    int nspinupstate() const { return 8; }
+    void getSpinupState( double x[] ) const;
+    void setSpinupState( const double x[] );
 
     void run1( const double runToDate );
 
@@ -81,6 +84,8 @@ private:
     virtual unitval getData( const std::string& varName,
                             const double date );
 
+    unitval chem_output( const unitval& x ) const;
+
     /*****************************************************************
      * State variables for the component
      * All of these will need to be recorded at the end of a timestep,
@@ -102,6 +107,10 @@ private:
 
     // Spinup mode flag
     bool in_spinup;         //!< Are we currently in spinup?
+    bool chem_skipped;      //!< Ocean not run this year (CO2 prescribed, concentration-driven)
+
+    //! Model holding the atmosphere, which may prescribe its CO2
+    CarbonCycleModel* atmos_model;
 
 
     /*****************************************************************
@@ -27,6 +27,7 @@
 #include "ocean_csys.hpp"
 
 #define MEAN_GLOBAL_TEMP 15
+#define OB_HISTORY_LENGTH 32    //!< past states kept per box; bounds connection windows and lookbacks
 
 namespace Hector {
 
@@ -46,7 +47,8 @@ private:
    	std::vector<double> carbonLossHistory;   //<! a vector of past C losses
 	std::vector<int> connection_window;      //<! a vector of connection windows to average over
 
-    double vectorHistoryMean( std::vector<double> v, int lookback ) const;
+    double vectorHistoryMean( const std::vector<double>& v, int lookback ) const;
+    void pushHistory( std::vector<double>& v, const double x );
 
     unitval compute_connection_flux( int i, double yf ) const;
 
@@ -73,6 +75,8 @@ public:
 	void new_year( const unitval Tgav );
 
 	void set_carbon( const unitval C );
+	double previous_carbon() const;
+	void restore_carbon( const unitval C, const double previous );
 	unitval get_carbon() const { return carbon; };
 	void add_carbon( unitval C );
 
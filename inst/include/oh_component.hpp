@@ -19,6 +19,7 @@
 #include "logger.hpp"
 #include "tseries.hpp"
 #include "unitval.hpp"
+#include "atmos_chemistry.hpp"
 
 namespace Hector {
 
@@ -28,6 +29,7 @@ namespace Hector {
  *  This doesn't do much yet.
  */
 class OHComponent : public IModelComponent {
+    friend class AtmosChemistry;
 
 public:
     OHComponent();
@@ -74,6 +76,11 @@ public:
     double CNOX;      // coefficent for NOX
     double CCH4;      // coefficent for CH4
 
+    //! Run the OH, CH4, N2O and ozone chemistry in one step each year
+    bool fused;
+    AtmosChemistry fused_chemistry;
+    AtmosChemistry* chemistry;
+
       // logger
     Logger logger;
 
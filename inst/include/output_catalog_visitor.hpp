@@ -0,0 +1,80 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef OUTPUT_CATALOG_VISITOR_H
+#define OUTPUT_CATALOG_VISITOR_H
+/*
+ *  output_catalog_visitor.hpp
+ *  hector
+ *
+ */
+
+#include <string>
+#include <vector>
+
+#include "avisitor.hpp"
+#include "output_subscription.hpp"
+#include "unitval.hpp"
+
+namespace Hector {
+
+/*! \brief A visitor which knows which variables each component reports as
+ *         output, and hands each subscribed one to output().
+ *
+ *  This is the single list of standard output variables, in the order they
+ *  are written.  Derived visitors decide what to do with each value (write a
+ *  csv line, record it for a file written at the end of the run, etc.).
+ *  Only subscribed variables are retrieved; by default, all of them.  Sea
+ *  level is first known some years into the run, at which point the values
+ *  for the earlier years are output with their dates.
+ */
+class OutputCatalogVisitor : public AVisitor {
+public:
+    OutputCatalogVisitor();
+    virtual ~OutputCatalogVisitor();
+
+    virtual bool shouldVisit( const bool in_spinup, const double date );
+
+    virtual void visit( Core* c );
+    virtual void visit( ForcingComponent* c );
+    virtual void visit( SimpleNbox* c );
+    virtual void visit( HalocarbonComponent* c );
+    virtual void visit( TemperatureComponent* c );
+    virtual void visit( slrComponent* c );
+    virtual void visit( OceanComponent* c );
+    virtual void visit( OzoneComponent* c );
+    virtual void visit( OHComponent* c );
+    virtual void visit( CH4Component* c );
+    virtual void visit( N2OComponent* c );
+
+    void subscribe( const std::vector<std::string>& vars );
+
+protected:
+    //! Output a value for the current period
+    virtual void output( const std::string& component, const std::string& name,
+                         const unitval& x ) = 0;
+
+    //! Output a value for an earlier (non-spinup) period
+    virtual void output( const std::string& component, const std::string& name,
+                         const unitval& x, double date ) = 0;
+
+    //! The variables to output
+    OutputSubscription subscription;
+
+    // Data retained while the visitor is operating
+    double current_date;
+    bool in_spinup;
+
+    //! Name of current run
+    std::string run_name;
+
+    //! pointers to other components and stuff
+    Core* core;
+};
+
+}
+
+#endif // OUTPUT_CATALOG_VISITOR_H
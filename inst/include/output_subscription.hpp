@@ -0,0 +1,79 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef OUTPUT_SUBSCRIPTION_H
+#define OUTPUT_SUBSCRIPTION_H
+/*
+ *  output_subscription.hpp
+ *  hector
+ *
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Hector {
+
+/*! \brief The variables an output visitor should write.
+ *
+ *  Each entry of the list is a component name (all of its variables), a
+ *  variable name of any component (e.g. `Tgav`), or both as
+ *  `<component>.<variable>` (e.g. `temperature.Tgav`, or
+ *  `simpleNbox.boreal.npp` for a biome).  An empty list means every
+ *  variable.  Visitors ask for the filter of a component once per visit,
+ *  skip the component if it wants nothing, and otherwise check each
+ *  variable before retrieving it.
+ */
+class OutputSubscription {
+public:
+    //! Which variables of one component are wanted
+    class Filter {
+    public:
+        Filter() : all( false ) {}
+
+        //! Whether any variable is wanted
+        bool any() const { return all || !variables.empty(); }
+
+        //! Whether a variable is wanted
+        bool operator()( const std::string& variable ) const {
+            if( all ) return true;
+            for( size_t i = 0; i < variables.size(); ++i ) {
+                if( variables[ i ] == variable ) return true;
+            }
+            return false;
+        }
+
+    private:
+        friend class OutputSubscription;
+        bool all;
+        std::vector<std::string> variables;
+    };
+
+    OutputSubscription();
+
+    void set( const std::vector<std::string>& vars );
+
+    //! Whether set has been called
+    bool isSet() const { return is_set; }
+
+    const Filter& forComponent( const std::string& component );
+
+    static std::vector<std::string> parse( const std::string& list );
+
+private:
+    //! The subscribed entries; empty for everything
+    std::vector<std::string> vars;
+
+    bool is_set;
+
+    //! Filters resolved so far, by component name
+    std::map<std::string, Filter> filters;
+};
+
+}
+
+#endif // OUTPUT_SUBSCRIPTION_H
@@ -0,0 +1,86 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef RECORDING_OUTPUT_VISITOR_H
+#define RECORDING_OUTPUT_VISITOR_H
+/*
+ *  recording_output_visitor.hpp
+ *  hector
+ *
+ */
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "output_catalog_visitor.hpp"
+#include "unitval.hpp"
+
+namespace Hector {
+
+/*! \brief A visitor which records the same results as CSVOutputStreamVisitor
+ *         in memory, for output formats written at the end of the run.
+ *
+ *  Every model period gets a record holding a value for each variable in the
+ *  dictionary, which lists variables in order of first output; values not
+ *  written in a period are NaN.  Sea level values are filled in for earlier
+ *  years once they are known.  The variables recorded are those of
+ *  OutputCatalogVisitor.  Derived classes write the records in their own
+ *  format when close() is called.
+ */
+class RecordingOutputVisitor : public OutputCatalogVisitor {
+public:
+    RecordingOutputVisitor( const std::string& fileName );
+    virtual ~RecordingOutputVisitor();
+
+    virtual bool shouldVisit( const bool in_spinup, const double date );
+
+    void close();
+
+protected:
+    //! Write the recorded results; called once, by close
+    virtual void write() = 0;
+
+    //! The file to write to
+    const std::string fileName;
+
+    //! Dictionary of variables: component, name and units, in order of first output
+    std::vector<std::string> components;
+    std::vector<std::string> names;
+    std::vector<std::string> units;
+
+    //! Date and spinup flag of each record
+    std::vector<double> dates;
+    std::vector<bool> spinup;
+
+    //! Values of each record, in dictionary order; shorter if variables were
+    //! added to the dictionary later
+    std::vector<std::vector<double> > records;
+
+    //! Record a value for the current period
+    virtual void output( const std::string& component, const std::string& name,
+                         const unitval& x );
+
+    //! Record a value for an earlier (non-spinup) period
+    virtual void output( const std::string& component, const std::string& name,
+                         const unitval& x, double date );
+
+private:
+    //! Record a value in the given record
+    void record( size_t r, const std::string& component, const std::string& name,
+                 const unitval& x );
+
+    //! Whether the file has been written
+    bool closed;
+
+    //! Position of each (component, name) in the dictionary
+    std::map<std::pair<std::string, std::string>, size_t> index;
+};
+
+}
+
+#endif // RECORDING_OUTPUT_VISITOR_H
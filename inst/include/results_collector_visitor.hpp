@@ -0,0 +1,86 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef RESULTS_COLLECTOR_VISITOR_H
+#define RESULTS_COLLECTOR_VISITOR_H
+/*
+ *  results_collector_visitor.hpp
+ *  hector
+ *
+ */
+
+#include <string>
+#include <vector>
+
+#include "avisitor.hpp"
+
+namespace Hector {
+
+class IModelComponent;
+
+/*! \brief A visitor which stores selected variables, for every year of the
+ *         run, in contiguous columns.
+ *
+ *  The variables are capabilities, as passed to Core::sendMessage (including
+ *  biome-qualified ones such as `boreal.npp`); the component that provides
+ *  each one is looked up once, when the collector is created.  Storage for
+ *  every year from the start to the end date is allocated up front, one
+ *  column per variable, so after a run a whole column is available as a
+ *  pointer and a length.  Spinup steps are not stored.
+ *
+ *  Usually created with Core::collectResults, which makes the core own it.
+ */
+class ResultsCollectorVisitor : public AVisitor {
+public:
+    ResultsCollectorVisitor( Core* core, const std::vector<std::string>& vars );
+    ~ResultsCollectorVisitor();
+
+    virtual bool shouldVisit( const bool in_spinup, const double date );
+
+    virtual void visit( Core* c );
+
+    void reset( double date );
+
+    //! The stored variables
+    size_t nvariables() const { return vars.size(); }
+    const std::string& variable( size_t i ) const { return vars.at( i ); }
+    const std::string& units( size_t i ) const { return var_units.at( i ); }
+    size_t findVariable( const std::string& var ) const;
+
+    //! Date of the first row of every column
+    double firstDate() const { return first_date; }
+
+    //! Number of years stored (the length of every column)
+    size_t nyears() const { return nrows; }
+
+    //! The values of a variable, one per year from firstDate
+    const double* column( size_t i ) const;
+
+private:
+    //! Make room for at least n rows
+    void reserve( size_t n );
+
+    //! The variables to store, and the components providing them
+    std::vector<std::string> vars;
+    std::vector<IModelComponent*> components;
+
+    //! Units of each variable, set when it is first stored
+    std::vector<std::string> var_units;
+
+    //! Values, one column of `capacity` rows per variable
+    std::vector<double> data;
+    size_t capacity;
+
+    //! Rows stored so far
+    size_t nrows;
+
+    double first_date;
+    double current_date;
+};
+
+}
+
+#endif // RESULTS_COLLECTOR_VISITOR_H
@@ -0,0 +1,101 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef SCENARIO_BUNDLE_H
+#define SCENARIO_BUNDLE_H
+/*
+ *  scenario_bundle.hpp
+ *  hector
+ *
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "h_exception.hpp"
+
+namespace Hector {
+
+class Core;
+
+/*! \brief A scenario (INI file and its input tables) in a single binary file.
+ *
+ *  A bundle holds, in INI file order, every value the INI file sets: plain
+ *  values as the strings given in the file, and each column of a csv: table
+ *  as arrays of dates and values with their units.  Applying a bundle to a
+ *  core makes the same setData calls as parsing the INI file, so the two are
+ *  equivalent, but loading a bundle is a single read with no path resolution
+ *  or text parsing, and needs no other files.  Bundles are written by INIToCoreReader::record and are
+ *  read by INIToCoreReader::parse, which recognizes them by their first
+ *  bytes.
+ *
+ *  File layout (native byte order, checked on reading): the magic string
+ *  "HECTORSB", a uint32 byte order mark, a uint32 format version, a uint32
+ *  entry count, then the entries.  Strings are a uint32 length followed by
+ *  their bytes.  Each entry is a uint8 kind, the section and variable names,
+ *  then for a value its date (double) and value string, for a file its name
+ *  and contents (strings), or for a series its units string, a uint32 length
+ *  n, n dates and n values (doubles).
+ *
+ *  Tables that components read themselves (land cells, temperature
+ *  patterns) are stored whole, as files, and handed to the component with
+ *  their original name (see message_data::file_contents), so the bundle does
+ *  not depend on where it or its INI file are.
+ */
+class ScenarioBundle {
+public:
+    //! Add a value set by the INI file
+    void addValue( const std::string& section, const std::string& name,
+                   const std::string& value, double date );
+
+    //! Add a table that a component reads itself
+    void addFile( const std::string& section, const std::string& name,
+                  const std::string& fileName );
+
+    //! Add a time series read from a table
+    void addSeries( const std::string& section, const std::string& name,
+                    const std::string& units, const std::vector<double>& dates,
+                    const std::vector<double>& values );
+
+    void write( const std::string& fileName ) const;
+    void read( const std::string& fileName );
+
+    void apply( Core* core ) const;
+
+    static bool isBundle( const std::string& fileName );
+
+    //! Current version of the file format
+    static const unsigned int version = 3;
+
+private:
+    //! Kinds of entry
+    enum entry_kind { VALUE = 0, SERIES = 1, FILE = 2 };
+
+    //! One value or series set by the INI file
+    struct entry {
+        entry_kind kind;
+        std::string section;
+        std::string name;
+        //! VALUE: the value and its date (Core::undefinedIndex() if none);
+        //! FILE: the file name
+        std::string value;
+        double date;
+        //! FILE: the file's contents
+        std::shared_ptr<const std::string> contents;
+        //! SERIES: units, dates, and values
+        std::string units;
+        std::vector<double> dates;
+        std::vector<double> values;
+    };
+
+    //! Entries in INI file order
+    std::vector<entry> entries;
+};
+
+}
+
+#endif // SCENARIO_BUNDLE_H
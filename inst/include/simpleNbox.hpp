@@ -20,26 +20,46 @@
 #include "carbon-cycle-model.hpp"
 
 #define SNBOX_ATMOS 0
-#define SNBOX_VEG 1
-#define SNBOX_DET 2
-#define SNBOX_SOIL 3
-#define SNBOX_OCEAN 4
-#define SNBOX_EARTH 5
+#define SNBOX_OCEAN 1
+#define SNBOX_EARTH 2
+#define SNBOX_NGLOBAL 3                 //!< number of global pools; biome pools follow in solver array
 #define MB_EPSILON 0.001                //!< allowed tolerance for mass-balance checks, Pg C
 #define SNBOX_PARSECHAR "."             //!< input separator between <biome> and <pool>
 #define SNBOX_DEFAULT_BIOME "global"    //!< value if no biome supplied
+#define Q10_TEMPLAG 0                   //!< lag of the soil Q10 temperature window, years (TODO: put in input files)
+#define Q10_TEMPN 200                   //!< length of the soil Q10 temperature window, years
 
 namespace Hector {
 
 /*! \brief The simple global carbon model, not including the ocean
  *
- *  SimpleNbox tracks atmosphere (1 pool), land (3 pools), ocean (1 pool from its p.o.v.),
- *  and earth (1 pool). The ocean component handles ocean processes; SimpleNbox just
- *  tracks the total ocean C.
+ *  SimpleNbox tracks atmosphere (1 pool), land (3 pools per biome), ocean (1 pool
+ *  from its p.o.v.), and earth (1 pool). The ocean component handles ocean
+ *  processes; SimpleNbox just tracks the total ocean C.
+ *
+ *  Biome-specific pools and parameters are stored as parallel arrays, indexed
+ *  by the biome's position in `biome_list`. In the solver's flat array the
+ *  global pools come first, followed by the vegetation, detritus, and soil
+ *  pools of every biome, each as a contiguous block.
+ *
+ *  The recorded histories are indexed by a history slot instead of by
+ *  position. Each biome gets a slot when it is created and keeps it when
+ *  other biomes are created, renamed, or deleted. A deleted biome's slot
+ *  goes on a free list and is handed to the next biome created, so the
+ *  rows don't grow with every biome ever created. Every row is stamped
+ *  with the order in which it was written, and a biome only reads the
+ *  rows written since it got its slot; years recorded before it existed
+ *  read as missing, and the deleted biome's values are never seen by the
+ *  new one. None of these operations has to touch the history.
+ *
+ *  Biomes can also stand for land grid cells: `land_cells=csv:<file>`
+ *  reads the pools and parameters of any number of them from one table
+ *  (see read_cell_table).
  */
 class SimpleNbox : public CarbonCycleModel {
     friend class CSVOutputVisitor;
     friend class CSVOutputStreamVisitor;
+    friend class OutputCatalogVisitor;
 
 public:
     SimpleNbox();
@@ -77,6 +97,11 @@ public:
     void slowparameval( double t, const double c[] );
     void stashCValues( double t, const double c[] );
     void record_state(double t);                        //!< record the state variables at the end of the time step
+    bool atmosphere_prescribed(double t) const { return CO2_constrain.size() && CO2_constrain.exists( t ); }
+    void prescribe_atmosphere(double t);                //!< set atmospheric CO2 from its constraint
+    int nspinupstate() const;
+    void getSpinupState( double x[] ) const;
+    void setSpinupState( const double x[] );
 
     void createBiome(const std::string& biome);
     void deleteBiome(const std::string& biome);
@@ -86,10 +111,16 @@ private:
     virtual unitval getData( const std::string& varName,
                             const double date );
 
-    // typedefs for two map types, to make things easier
-    // TODO: these should probably be defined in h_util.hpp or someplace similar?
-    typedef std::map<std::string, unitval> unitval_stringmap;
-    typedef std::map<std::string, double> double_stringmap;
+    // Per-biome data are stored as contiguous arrays, indexed by the
+    // biome's position in `biome_list`.  Pools are in Pg C, fluxes in
+    // Pg C/yr, and everything else is unitless.
+    typedef std::vector<double> double_vector;
+
+    //! A biome array as recorded in the histories, indexed by history slot
+    struct history_row_t {
+        double_vector value;        //!< value of each slot
+        unsigned long written;      //!< write count when the row was recorded
+    };
 
     /*****************************************************************
      * Component state
@@ -97,8 +128,14 @@ private:
      * step so that we can reset to any arbitrary past time.
      *****************************************************************/
 
-    // List of biomes
+    // Biome table: names, in order, and the history slot of each
     std::vector<std::string> biome_list;
+    std::vector<int> biome_slot;    //!< slot of each biome in the recorded histories
+    std::map<std::string, int> biome_pos; //!< position of each biome in biome_list
+    int nslots;                     //!< number of slots in a history row
+    std::vector<int> free_slots;    //!< slots of deleted biomes, to be handed out again
+    std::vector<unsigned long> slot_since; //!< write count when each slot was last handed out
+    unsigned long history_writes;   //!< number of history rows written so far
 
     // Carbon pools -- global
     unitval earth_c;                //!< earth pool, Pg C; for mass-balance
@@ -106,13 +143,13 @@ private:
     unitval    Ca;                  //!< current [CO2], ppmv
 
     // Carbon pools -- biome-specific
-    unitval_stringmap veg_c;        //!< vegetation pools, Pg C
-    unitval_stringmap detritus_c;   //!< detritus pools, Pg C
-    unitval_stringmap soil_c;       //!< soil pool, Pg C
+    double_vector veg_c;            //!< vegetation pools, Pg C
+    double_vector detritus_c;       //!< detritus pools, Pg C
+    double_vector soil_c;           //!< soil pool, Pg C
 
     unitval residual;               //!< residual (when constraining Ca) flux, Pg C
 
-    double_stringmap tempfertd, tempferts; //!< temperature effect on respiration (unitless)
+    double_vector tempfertd, tempferts; //!< temperature effect on respiration (unitless)
 
     /*****************************************************************
      * Records of component state
@@ -124,13 +161,13 @@ private:
     tseries<unitval> atmos_c_ts;  //!< Time series of atmosphere carbon pool
     tseries<unitval> Ca_ts;       //!< Time series of atmosphere CO2 concentration
 
-    tvector<unitval_stringmap> veg_c_tv;      //!< Time series of biome-specific vegetation carbon pools
-    tvector<unitval_stringmap> detritus_c_tv; //!< Time series of biome-specific detritus carbon pools
-    tvector<unitval_stringmap> soil_c_tv;     //!< Time series of biome-specific soil carbon pools
+    tvector<history_row_t> veg_c_tv;      //!< Time series of biome-specific vegetation carbon pools
+    tvector<history_row_t> detritus_c_tv; //!< Time series of biome-specific detritus carbon pools
+    tvector<history_row_t> soil_c_tv;     //!< Time series of biome-specific soil carbon pools
 
     tseries<unitval> residual_ts; //!< Time series of residual flux values
 
-    tvector<double_stringmap> tempfertd_tv, tempferts_tv; //!< Time series of temperature effect on respiration
+    tvector<history_row_t> tempfertd_tv, tempferts_tv; //!< Time series of temperature effect on respiration
 
 
     /*****************************************************************
@@ -140,9 +177,20 @@ private:
      * they do need to be recalculated whenever we reset.
      *****************************************************************/
 
-    double_stringmap co2fert;           //!< CO2 fertilization effect (unitless)
+    double_vector co2fert;              //!< CO2 fertilization effect (unitless)
+
+    // Per-biome fluxes.  These depend only on the pools and parameters
+    // at the start of a time step, so they are computed once per step
+    // in slowparameval and shared by every derivative evaluation.
+    double_vector dveg_step, ddet_step, dsoil_step; //!< pool tendencies excluding land-use change, Pg C/yr
+    double_vector luc_share_veg, luc_share_det, luc_share_soil; //!< biome share of land-use change emissions
+    double npp_step, rh_fda_step, rh_fsa_step; //!< global NPP and RH over the time step, Pg C/yr
     tseries<double> Tgav_record;        //!< Record of global temperature values, for computing soil RH
+    double_vector Tgav_window;          //!< Ring buffer of the Tgav_record values in the soil Q10 window, slot = year mod Q10_TEMPN
+    double Tgav_window_sum;             //!< Running sum of Tgav_window
+    double Tgav_window_t;               //!< Time whose window Tgav_window holds, or undefinedIndex if it must be rebuilt
     bool in_spinup;                     //!< flag tracking spinup state
+    bool cycle_skipped;                 //!< carbon cycle not run this year (CO2 prescribed, concentration-driven)
     double tcurrent;                    //!< Current time (last completed time step)
     double masstot;                     //!< tracker for mass conservation
     unitval atmosland_flux;             //!< Atmosphere -> land C flux
@@ -172,111 +220,61 @@ private:
      *****************************************************************/
 
     // Partitioning
-    double_stringmap f_nppv, f_nppd;      //!< fraction NPP into vegetation and detritus
-    double_stringmap f_litterd;           //!< fraction of litter to detritus
+    double_vector f_nppv, f_nppd;       //!< fraction NPP into vegetation and detritus
+    double_vector f_litterd;            //!< fraction of litter to detritus
 
     double f_lucv, f_lucd;      //!< fraction LUC from vegetation and detritus
 
     // Initial fluxes
-    unitval_stringmap npp_flux0;       //!< preindustrial NPP
+    double_vector npp_flux0;            //!< preindustrial NPP, Pg C/yr
 
     // Atmospheric CO2, temperature, and their effects
     unitval    C0;                      //!< preindustrial [CO2], ppmv
 
-    double_stringmap beta,           //!< shape of CO2 response
+    double_vector beta,             //!< shape of CO2 response
     //                        sigma,          //!< shape of temperature response (not yet implemented)
         warmingfactor;  //!< regional warming relative to global (1.0=same)
 
-    double_stringmap q10_rh;            //!< Q10 for heterotrophic respiration (unitless)
+    double_vector q10_rh;               //!< Q10 for heterotrophic respiration (unitless)
 
     /*****************************************************************
      * Functions computing sub-elements of the carbon cycle
      *****************************************************************/
-    double calc_co2fert(std::string biome, double time = Core::undefinedIndex()) const; //!< calculates co2fertilization factor.
-    unitval npp(std::string biome, double time = Core::undefinedIndex()) const; //!< calculates NPP for a biome
+    double calc_co2fert(const int biome, double time = Core::undefinedIndex()) const; //!< calculates co2fertilization factor.
+    unitval npp(const int biome, double time = Core::undefinedIndex()) const; //!< calculates NPP for a biome
     unitval sum_npp(double time = Core::undefinedIndex()) const; //!< calculates NPP, global total
-    unitval rh_fda( std::string biome ) const;  //!< calculates current RH from detritus for a biome
-    unitval rh_fsa( std::string biome ) const;  //!< calculates current RH from soil for a biome
-    unitval rh( std::string biome ) const;      //!< calculates current RH for a biome
+    unitval rh_fda( const int biome ) const;    //!< calculates current RH from detritus for a biome
+    unitval rh_fsa( const int biome ) const;    //!< calculates current RH from soil for a biome
+    unitval rh( const int biome ) const;        //!< calculates current RH for a biome
     unitval sum_rh() const;                     //!< calculates current RH, global total
 
     /*****************************************************************
      * Private helper functions
      *****************************************************************/
     void sanitychecks();                                //!< performs mass-balance and other checks
-    unitval sum_map( unitval_stringmap pool ) const;    //!< sums a unitval map (collection of data)
-    double sum_map( double_stringmap pool ) const;      //!< sums a double map (collection of data)
+    double sum_vector( const double_vector& pool ) const; //!< sums a biome array (collection of data)
     void log_pools( const double t );                   //!< prints pool status to the log file
     void set_c0(double newc0);                          //!< set initial co2 and adjust total carbon mass
-
-    bool has_biome(const std::string& biome);
+    double Tgav_window_mean( const double t );          //!< mean Tgav over the soil Q10 window ending at t
+    void calc_land_fluxes();                            //!< per-biome fluxes for the current time step
+
+    bool has_biome(const std::string& biome) const;
+    int biome_index(const std::string& biome) const;    //!< position of `biome` in `biome_list`, or -1
+    int nbiomes() const { return int( biome_list.size() ); }
+    void add_biome_data(const std::string& biome);      //!< append a biome, with unset parameters and pools
+    void erase_biome_data(const int i);                 //!< remove the biome at position i
+    void drop_global_biome();                           //!< remove "global" to make way for named biomes
+    void read_cell_table( const std::string& fileName,
+                          const std::shared_ptr<const std::string>& contents ); //!< load per-biome (cell) data from a CSV table
 
     CarbonCycleModel *omodel;           //!< pointer to the ocean model in use
 
-    // Add a biome to a time-series map variable (e.g. veg_c_tv)
-    template <class T_data>
-    void add_biome_to_ts(tvector<std::map<std::string, T_data>>& ts,
-                         const std::string& biome,
-                         T_data init_value) {
-        // First, check if a biome of this name already exists in the data
-        if ( ts.get(ts.firstdate()).count( biome ) ) {
-            H_THROW( "Biome '" + biome + "' already exists in data." );
-        }
-
-        // Loop over time steps, and set the variable to the provided `init_value`
-        std::map<std::string, T_data> newval;
-        for ( double i = ts.firstdate(); i < ts.lastdate(); i++ ) {
-            if (ts.exists(i)) {
-                newval = ts.get(i);
-                newval[ biome ] = init_value;
-                ts.set(i, newval);
-            }
-        }
-    }
-
-    // Remove a biome from a time-series map variable
-    template <class T_map>
-    void remove_biome_from_ts(tvector<T_map>& ts,
-                              const std::string& biome) {
-        // We don't need to check for presence of `biome` here because the
-        // `<std::map>.erase()` method is effectively a no-op when given a
-        // non-existent key.
-        T_map currval;
-        for ( double i = ts.firstdate(); i < ts.lastdate(); i++ ) {
-            if (ts.exists(i)) {
-                currval = ts.get(i);
-                currval.erase(biome);
-                ts.set(i, currval);
-            }
-        }
-    }
-
-    // Rename a biome in a time-series map variable. At each time
-    // step, this creates a new biome called `newname`, gives it all
-    // of the values of `oldname`, and then erases that time step's
-    // `oldname`.
-    template <class T_map>
-    void rename_biome_in_ts(tvector<T_map>& ts,
-                            const std::string& oldname,
-                            const std::string& newname) {
-        if ( !ts.get(ts.firstdate()).count( oldname ) ) {
-            H_THROW( "Biome '" + oldname + "' not found in data.");
-        }
-        if ( ts.get(ts.firstdate()).count( newname ) ) {
-            H_THROW( "Biome '" + newname + "' already exists in data.");
-        }
-
-        T_map currval;
-        for ( double i = ts.firstdate(); i < ts.lastdate(); i++ ) {
-            if (ts.exists(i)) {
-                currval = ts.get(i);
-                currval[newname] = currval.at(oldname);
-                currval.erase(oldname);
-                ts.set(i, currval);
-            }
-        }
-    }
-
+    history_row_t history_row( const double_vector& pool ); //!< biome array -> history row, by slot
+    void from_history_row( const history_row_t& row, double_vector& pool,
+                           const double missing ) const; //!< history row -> biome array
+    double history_value( const history_row_t& row, const int i,
+                          const double missing ) const;  //!< value of biome i in a history row
+    double history_sum( const history_row_t& row ) const; //!< sum of a history row over current biomes
 
 };
 
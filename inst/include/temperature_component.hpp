@@ -14,6 +14,8 @@
  *
  */
 
+#include <memory>
+
 #include "forcing_component.hpp"
 #include "imodel_component.hpp"
 #include "logger.hpp"
@@ -35,6 +37,10 @@ namespace Hector {
  *  Kriegler, E. (2005) Imprecise probability analysis for Integrated Assessment of climate change. Ph.D. dissertation. Potsdam Universität. 256 pp. (http://opus.kobv.de/ubp/volltexte/2005/561/; DOECLIM introduced in Chapter 2 and Annexes A and B)
  *  Tanaka, K. & Kriegler, E. (2007) Aggregated carbon cycle, atmospheric chemistry, and climate model (ACC2) – Description of the forward and inverse modes – . Reports Earth Syst. Sci. 199.
  *  Garner, G., Reed, P. & Keller, K. (2016) Climate risk management requires explicit representation of societal trade-offs. Clim. Change 134, 713–723.
+ *
+ *  Optionally, a temperature pattern (`pattern=csv:<file>`, see read_pattern)
+ *  scales the global mean to a grid: each cell's temperature anomaly is
+ *  slope * Tgav + intercept, updated every time step.
  */
 class TemperatureComponent : public IModelComponent {
 
@@ -65,15 +71,29 @@ public:
     //! IVisitable methods
     virtual void accept( AVisitor* visitor );
 
+    //! Number of cells in the temperature pattern (0 if none was given)
+    size_t npatterncell() const { return pattern_slope.size(); }
+    //! Latitude of each pattern cell, degrees
+    const std::vector<float>& pattern_latitude() const { return pattern_lat; }
+    //! Longitude of each pattern cell, degrees
+    const std::vector<float>& pattern_longitude() const { return pattern_lon; }
+    //! Pattern-scaled temperature anomaly of each cell at the current date, deg C
+    const std::vector<float>& gridded_temperature() const { return gridded_temp; }
+
 private:
     virtual unitval getData( const std::string& varName,
                             const double date );
     void invert_1d_2x2_matrix( double * x, double * y);
     void setoutputs(int tstep);
+    void extend_horizon(int tstep);
+    double memory_sum(int tstep);
+    void read_pattern( const std::string& fileName,
+                       const std::shared_ptr<const std::string>& contents );
+    void scale_pattern();
 
     // Hard-coded DOECLIM parameters
-    const int dt = 1;                     // years per timestep (this is implicit in Hector)
-    int ns;                               // number of timesteps
+    static const int dt = 1;              // years per timestep (this is implicit in Hector)
+    int ns;                               // number of timesteps allocated (grows if the run goes past endDate)
     const double ak = 0.31;               // slope in climate feedback - land-sea heat exchange linear relationship
     const double bk = 1.59;               // offset in climate feedback - land-sea heat exchange linear relationship, W/m2/K
     const double csw = 0.13;              // specific heat capacity of seawater W*yr/m3/K
@@ -105,21 +125,26 @@ private:
     double tauksl;           // sea-land heat exchange time scale, yr
     double taukls;           // land-sea heat exchange time scale, yr
 
-    std::vector<double> KT0;
-    std::vector<double> KTA1;
-    std::vector<double> KTB1;
-    std::vector<double> KTA2;
-    std::vector<double> KTB2;
-    std::vector<double> KTA3;
-    std::vector<double> KTB3;
-
     // Components of the difference equation system B*T(i+1) = Q(i) + A*T(i)
     double B[4];
     double C[4];
-    std::vector<double> Ker;
     double A[4];
     double IB[4];
 
+    // The diffusion memory term sums temp_sst over all past timesteps,
+    // weighted by the kernel.  Lags below nnear are summed directly; beyond
+    // that the kernel is fitted by a sum of exponentials, whose partial sums
+    // can be advanced by one step at a time, so a run is linear in its length.
+    // The kernel depends only on ns and taubot, and is shared between cores.
+    static const int nnear = 64;          // lags summed directly
+    static const int ntail = 32;          // exponentials in the kernel tail fit
+    struct Kernel;
+    static std::shared_ptr<const Kernel> get_kernel( const int ns, const double taubot );
+    std::shared_ptr<const Kernel> kernel;
+    std::vector<double> tail_state;       // partial sums of each exponential at tail_tstep
+    int tail_tstep;                       // timestep that tail_state belongs to
+    std::vector<double> dpast;            // memory sum at each timestep
+
     // Time series arrays that are updated with each DOECLIM time-step
     std::vector<double> temp;
     std::vector<double> temp_landair;
@@ -148,6 +173,14 @@ private:
 
     tseries<unitval> tgav_constrain;        //! Temperature change can be supplied (not currently)
 
+    // Temperature pattern, one entry per grid cell.  Single precision
+    // halves the memory traffic of scaling a large grid every step.
+    std::vector<float> pattern_lat;         //!< cell latitude, degrees
+    std::vector<float> pattern_lon;         //!< cell longitude, degrees
+    std::vector<float> pattern_slope;       //!< cell warming per degree of Tgav
+    std::vector<float> pattern_intercept;   //!< cell anomaly at zero Tgav, deg C
+    std::vector<float> gridded_temp;        //!< cell temperature anomaly at the current date, deg C
+
     //! pointers to other components and stuff
     Core*             core;
 
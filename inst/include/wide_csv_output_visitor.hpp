@@ -0,0 +1,46 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+#ifndef WIDE_CSV_OUTPUT_VISITOR_H
+#define WIDE_CSV_OUTPUT_VISITOR_H
+/*
+ *  wide_csv_output_visitor.hpp
+ *  hector
+ *
+ */
+
+#include <string>
+
+#include "recording_output_visitor.hpp"
+
+namespace Hector {
+
+/*! \brief A visitor which writes the results recorded by
+ *         RecordingOutputVisitor as a wide csv table.
+ *
+ *  The header row is `year` followed by a `<component>.<variable>[<units>]`
+ *  column for every variable written, and each row after it holds all of
+ *  one year's values, so the file reads directly into a data frame.  Spinup
+ *  periods are not written, and values that are missing or that a variable
+ *  does not have in a year are written as `NA`.  The file is written by
+ *  close().
+ */
+class WideCSVOutputVisitor : public RecordingOutputVisitor {
+public:
+    WideCSVOutputVisitor( const std::string& fileName, int precision = 6 );
+    ~WideCSVOutputVisitor();
+
+protected:
+    virtual void write();
+
+private:
+    //! Significant digits of output values
+    const int precision;
+};
+
+}
+
+#endif // WIDE_CSV_OUTPUT_VISITOR_H
@@ -1814,6 +1814,33 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// write_bundle
+String write_bundle(String inifile, String bundlefile);
+RcppExport SEXP _hector_write_bundle(SEXP inifileSEXP, SEXP bundlefileSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< String >::type inifile(inifileSEXP);
+    Rcpp::traits::input_parameter< String >::type bundlefile(bundlefileSEXP);
+    rcpp_result_gen = Rcpp::wrap(write_bundle(inifile, bundlefile));
+    return rcpp_result_gen;
+END_RCPP
+}
+// read_binary_output
+DataFrame read_binary_output(String filename, CharacterVector vars, double startdate, double enddate, bool spinup);
+RcppExport SEXP _hector_read_binary_output(SEXP filenameSEXP, SEXP varsSEXP, SEXP startdateSEXP, SEXP enddateSEXP, SEXP spinupSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< String >::type filename(filenameSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type vars(varsSEXP);
+    Rcpp::traits::input_parameter< double >::type startdate(startdateSEXP);
+    Rcpp::traits::input_parameter< double >::type enddate(enddateSEXP);
+    Rcpp::traits::input_parameter< bool >::type spinup(spinupSEXP);
+    rcpp_result_gen = Rcpp::wrap(read_binary_output(filename, vars, startdate, enddate, spinup));
+    return rcpp_result_gen;
+END_RCPP
+}
 // shutdown
 Environment shutdown(Environment core);
 RcppExport SEXP _hector_shutdown(SEXP coreSEXP) {
@@ -1908,6 +1935,29 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// collect_results
+Environment collect_results(Environment core, std::vector<std::string> vars);
+RcppExport SEXP _hector_collect_results(SEXP coreSEXP, SEXP varsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment >::type core(coreSEXP);
+    Rcpp::traits::input_parameter< std::vector<std::string> >::type vars(varsSEXP);
+    rcpp_result_gen = Rcpp::wrap(collect_results(core, vars));
+    return rcpp_result_gen;
+END_RCPP
+}
+// fetch_results
+DataFrame fetch_results(Environment core);
+RcppExport SEXP _hector_fetch_results(SEXP coreSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< Environment >::type core(coreSEXP);
+    rcpp_result_gen = Rcpp::wrap(fetch_results(core));
+    return rcpp_result_gen;
+END_RCPP
+}
 // sendmessage
 DataFrame sendmessage(Environment core, String msgtype, String capability, NumericVector date, NumericVector value, String unit);
 RcppExport SEXP _hector_sendmessage(SEXP coreSEXP, SEXP msgtypeSEXP, SEXP capabilitySEXP, SEXP dateSEXP, SEXP valueSEXP, SEXP unitSEXP) {
@@ -2116,6 +2166,8 @@ static const R_CallMethodDef CallEntries[] = {
     {"_hector_HEAT_FLUX", (DL_FUNC) &_hector_HEAT_FLUX, 0},
     {"_hector_BIOME_SPLIT_CHAR", (DL_FUNC) &_hector_BIOME_SPLIT_CHAR, 0},
     {"_hector_newcore_impl", (DL_FUNC) &_hector_newcore_impl, 4},
+    {"_hector_write_bundle", (DL_FUNC) &_hector_write_bundle, 2},
+    {"_hector_read_binary_output", (DL_FUNC) &_hector_read_binary_output, 5},
     {"_hector_shutdown", (DL_FUNC) &_hector_shutdown, 1},
     {"_hector_reset", (DL_FUNC) &_hector_reset, 2},
     {"_hector_run", (DL_FUNC) &_hector_run, 2},
@@ -2124,6 +2176,8 @@ static const R_CallMethodDef CallEntries[] = {
     {"_hector_create_biome_impl", (DL_FUNC) &_hector_create_biome_impl, 2},
     {"_hector_delete_biome_impl", (DL_FUNC) &_hector_delete_biome_impl, 2},
     {"_hector_rename_biome", (DL_FUNC) &_hector_rename_biome, 3},
+    {"_hector_collect_results", (DL_FUNC) &_hector_collect_results, 2},
+    {"_hector_fetch_results", (DL_FUNC) &_hector_fetch_results, 1},
     {"_hector_sendmessage", (DL_FUNC) &_hector_sendmessage, 6},
     {"_hector_chk_core_valid", (DL_FUNC) &_hector_chk_core_valid, 1},
     {NULL, NULL, 0}
@@ -0,0 +1,132 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  async_stream_writer.cpp
+ *  hector
+ *
+ */
+
+#include <system_error>
+
+#include "async_stream_writer.hpp"
+
+namespace Hector {
+
+using namespace std;
+
+//! Full buffers allowed to wait for the writer before commit blocks
+static const size_t max_pending = 8;
+
+//------------------------------------------------------------------------------
+/*! \brief Constructor
+ *  \param out The stream to write to.
+ *  \param bufferSize Size at which buffers are handed to the writer thread.
+ */
+AsyncStreamWriter::AsyncStreamWriter( ostream& out, size_t bufferSize )
+: out( out ), bufferSize( bufferSize ), writing( false ), stopping( false )
+{
+    current.reserve( bufferSize + bufferSize / 4 );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Destructor
+ *
+ *  Writes anything still buffered and stops the writer thread.
+ */
+AsyncStreamWriter::~AsyncStreamWriter() {
+    flush();
+    if( writer.joinable() ) {
+        {
+            lock_guard<mutex> lock( queueMutex );
+            stopping = true;
+        }
+        workReady.notify_one();
+        writer.join();
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Write everything appended so far, and flush the stream
+ *
+ *  Waits for the writer thread to finish.
+ */
+void AsyncStreamWriter::flush() {
+    if( !current.empty() ) {
+        handOff();
+    }
+    {
+        unique_lock<mutex> lock( queueMutex );
+        while( !pending.empty() || writing ) {
+            workDone.wait( lock );
+        }
+    }
+    out.flush();
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Queue the current buffer for writing and start a new one
+ */
+void AsyncStreamWriter::handOff() {
+    {
+        unique_lock<mutex> lock( queueMutex );
+        while( pending.size() >= max_pending ) {
+            workDone.wait( lock );
+        }
+        pending.push_back( string() );
+        pending.back().swap( current );
+        if( !spare.empty() ) {
+            current.swap( spare.back() );
+            spare.pop_back();
+        } else {
+            current.reserve( bufferSize + bufferSize / 4 );
+        }
+        if( !writer.joinable() ) {
+            try {
+                writer = thread( &AsyncStreamWriter::writeLoop, this );
+            } catch( system_error& ) {
+                // no threads available; write synchronously
+                out.write( pending.back().data(), pending.back().size() );
+                pending.back().clear();
+                spare.push_back( string() );
+                spare.back().swap( pending.back() );
+                pending.pop_back();
+            }
+        }
+    }
+    workReady.notify_one();
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Body of the writer thread
+ */
+void AsyncStreamWriter::writeLoop() {
+    string buf;
+    unique_lock<mutex> lock( queueMutex );
+    while( true ) {
+        while( pending.empty() && !stopping ) {
+            workReady.wait( lock );
+        }
+        if( pending.empty() ) {
+            return;             // stopping
+        }
+        buf.swap( pending.front() );
+        pending.pop_front();
+        writing = true;
+
+        lock.unlock();
+        out.write( buf.data(), buf.size() );
+        buf.clear();
+        lock.lock();
+
+        spare.push_back( string() );
+        spare.back().swap( buf );
+        writing = false;
+        workDone.notify_all();
+    }
+}
+
+}
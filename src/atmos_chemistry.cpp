@@ -0,0 +1,305 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  atmos_chemistry.cpp
+ *  hector
+ *
+ */
+
+#include <math.h>
+#include <limits>
+
+#include "atmos_chemistry.hpp"
+#include "oh_component.hpp"
+#include "ch4_component.hpp"
+#include "n2o_component.hpp"
+#include "o3_component.hpp"
+#include "core.hpp"
+#include "h_util.hpp"
+
+namespace Hector {
+
+using namespace std;
+
+const char *AtmosChemistry::chem_inputs[] = {
+    D_EMISSIONS_NOX,
+    D_EMISSIONS_CO,
+    D_EMISSIONS_NMVOC,
+    D_EMISSIONS_CH4,
+    D_CONSTRAINT_CH4,
+    D_EMISSIONS_N2O,
+    D_NAT_EMISSIONS_N2O,
+    D_CONSTRAINT_N2O,
+    D_PREINDUSTRIAL_CH4,
+    D_INITIAL_LIFETIME_OH,
+    D_COEFFICENT_CH4,
+    D_COEFFICENT_NOX,
+    D_COEFFICENT_CO,
+    D_COEFFICENT_NMVOC,
+    D_CONVERSION_CH4,
+    D_NATURAL_CH4,
+    D_LIFETIME_SOIL,
+    D_LIFETIME_STRAT,
+    D_PREINDUSTRIAL_N2O,
+    D_CONVERSION_N2O,
+    D_INITIAL_LIFETIME_N2O,
+    NULL
+};
+
+//------------------------------------------------------------------------------
+/*! \brief Constructor
+ */
+AtmosChemistry::AtmosChemistry()
+:core( 0 ), oh( 0 ), ch4( 0 ), n2o( 0 ), o3( 0 ),
+ table_start( 0 ), table_version( 0 ), lastDate( 0 ),
+ ch4_prev( 0 ), n2o_prev( 0 ), stale( true )
+{
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Find the fused chemistry for a core
+ *  \returns The OH component's chemistry, if it has been enabled and all four
+ *           components are running, or NULL.
+ */
+AtmosChemistry* AtmosChemistry::find( Core* core ) {
+    if( !core->checkCapability( D_LIFETIME_OH ) || !core->checkCapability( D_ATMOSPHERIC_CH4 ) ||
+        !core->checkCapability( D_ATMOSPHERIC_N2O ) || !core->checkCapability( D_ATMOSPHERIC_O3 ) ) {
+        return 0;
+    }
+    OHComponent* oh = dynamic_cast<OHComponent*>( core->getComponentByCapability( D_LIFETIME_OH ) );
+    return oh && oh->fused ? &oh->fused_chemistry : 0;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Start a new run; components and inputs are looked up on the first year
+ */
+void AtmosChemistry::prepareToRun( Core* coreptr ) {
+    core = coreptr;
+    lastDate = core->getStartDate();
+    table.clear();
+    stale = true;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Reset to an earlier date; the components' time series are
+ *         truncated by the components themselves
+ */
+void AtmosChemistry::reset( const double time ) {
+    lastDate = time;
+    stale = true;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Look up the components and load the parameters and state
+ *  \returns true if successful
+ */
+bool AtmosChemistry::bind() {
+    oh = dynamic_cast<OHComponent*>( core->getComponentByCapability( D_LIFETIME_OH ) );
+    ch4 = dynamic_cast<CH4Component*>( core->getComponentByCapability( D_ATMOSPHERIC_CH4 ) );
+    n2o = dynamic_cast<N2OComponent*>( core->getComponentByCapability( D_ATMOSPHERIC_N2O ) );
+    o3 = dynamic_cast<OzoneComponent*>( core->getComponentByCapability( D_ATMOSPHERIC_O3 ) );
+    if( !oh || !ch4 || !n2o || !o3 ) {
+        return false;
+    }
+
+    params.M0_OH = oh->M0.value( U_PPBV_CH4 );
+    params.TOH0 = oh->TOH0.value( U_YRS );
+    params.CCH4 = oh->CCH4;
+    params.CNOX = oh->CNOX;
+    params.CCO = oh->CCO;
+    params.CNMVOC = oh->CNMVOC;
+    params.NOX0 = oh->NOX_emissions.get( oh->NOX_emissions.firstdate() ).value( U_TG_N );
+    params.CO0 = oh->CO_emissions.get( oh->CO_emissions.firstdate() ).value( U_TG_CO );
+    params.NMVOC0 = oh->NMVOC_emissions.get( oh->NMVOC_emissions.firstdate() ).value( U_TG_NMVOC );
+
+    params.UC_CH4 = ch4->UC_CH4.value( U_TG_PPBV );
+    params.CH4N = ch4->CH4N.value( U_TG_CH4 );
+    params.Tsoil = ch4->Tsoil.value( U_YRS );
+    params.Tstrat = ch4->Tstrat.value( U_YRS );
+
+    params.N0 = n2o->N0.value( U_PPBV_N2O );
+    params.UC_N2O = n2o->UC_N2O.value( U_TG_PPBV );
+    params.TN2O0 = n2o->TN2O0.value( U_YRS );
+
+    ch4_prev = ch4->CH4.get( lastDate ).value( U_PPBV_CH4 );
+    n2o_prev = n2o->N2O.get( lastDate ).value( U_PPBV_N2O );
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Gather the inputs for one year from the components
+ *  \exception h_exception If an input is not available for the date.
+ */
+void AtmosChemistry::gather( const double date, double in[] ) const {
+    const double missing = numeric_limits<double>::quiet_NaN();
+
+    in[ CI_NOX_OH ] = oh->NOX_emissions.get( date ).value( U_TG_N );
+    in[ CI_CO_OH ] = oh->CO_emissions.get( date ).value( U_TG_CO );
+    in[ CI_NMVOC_OH ] = oh->NMVOC_emissions.get( date ).value( U_TG_NMVOC );
+    in[ CI_NOX_O3 ] = o3->NOX_emissions.get( date ).value( U_TG_N );
+    in[ CI_CO_O3 ] = o3->CO_emissions.get( date ).value( U_TG_CO );
+    in[ CI_NMVOC_O3 ] = o3->NMVOC_emissions.get( date ).value( U_TG_NMVOC );
+
+    if( ch4->CH4_constrain.size() && ch4->CH4_constrain.exists( date ) ) {
+        in[ CI_CH4_EMISS ] = missing;
+        in[ CI_CH4_CONSTRAIN ] = ch4->CH4_constrain.get( date ).value( U_PPBV_CH4 );
+    } else {
+        in[ CI_CH4_EMISS ] = ch4->CH4_emissions.get( date ).value( U_TG_CH4 );
+        in[ CI_CH4_CONSTRAIN ] = missing;
+    }
+
+    if( n2o->N2O_constrain.size() && n2o->N2O_constrain.exists( date ) ) {
+        in[ CI_N2O_EMISS ] = missing;
+        in[ CI_N2O_CONSTRAIN ] = n2o->N2O_constrain.get( date ).value( U_PPBV_N2O );
+    } else {
+        // Current emissions are the sum of natural and anthropogenic sources
+        in[ CI_N2O_EMISS ] = n2o->N2O_emissions.get( date ).value( U_TG_N ) +
+            n2o->N2O_natural_emissions.get( date ).value( U_TG_N );
+        in[ CI_N2O_CONSTRAIN ] = missing;
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Tabulate the inputs from a date to the end date
+ *  \details The table stops at the first year whose inputs can't be
+ *           gathered; that year and any after it are gathered on demand.
+ */
+void AtmosChemistry::tabulate( const double from ) {
+    table.clear();
+    table_start = from;
+    table_version = core->getInputVersion();
+    double row[ N_CHEM_INPUTS ];
+    for( double date = from; date <= core->getEndDate(); date += 1.0 ) {
+        try {
+            gather( date, row );
+        } catch( h_exception& e ) {
+            break;
+        }
+        table.insert( table.end(), row, row + N_CHEM_INPUTS );
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Check that no input or parameter of the chemistry has changed
+ *         since the table was built
+ *  \details Inputs of other components only bring table_version up to date.
+ */
+bool AtmosChemistry::table_current() {
+    if( core->getInputVersion() == table_version ) {
+        return true;
+    }
+    for( int i = 0; chem_inputs[ i ]; ++i ) {
+        if( core->getInputVersion( chem_inputs[ i ] ) > table_version ) {
+            table_version = core->getInputVersion();
+            return false;
+        }
+    }
+    // Only unrelated inputs have been set
+    table_version = core->getInputVersion();
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Advance all four components to a date
+ *  \details Does nothing if they have already been advanced, so each of the
+ *           components can call this from its run().
+ */
+void AtmosChemistry::run( const double runToDate ) {
+    if( runToDate <= lastDate ) {
+        return;
+    }
+    H_ASSERT( !core->inSpinup() && runToDate-lastDate == 1, "timestep must equal 1" );
+
+    if( stale ) {
+        H_ASSERT( bind(), "fused chemistry requires the OH, CH4, N2O and ozone components" );
+        tabulate( runToDate );
+        stale = false;
+    } else if( !table_current() ) {
+        // Reload the parameters, and gather inputs year by year until the
+        // next reset
+        H_ASSERT( bind(), "fused chemistry requires the OH, CH4, N2O and ozone components" );
+        table.clear();
+    }
+
+    const double *in;
+    double row[ N_CHEM_INPUTS ];
+    const size_t i = size_t( ::round( runToDate - table_start ) );
+    if( runToDate >= table_start && ( i + 1 ) * N_CHEM_INPUTS <= table.size() ) {
+        in = &table[ i * N_CHEM_INPUTS ];
+    } else {
+        gather( runToDate, row );
+        in = row;
+    }
+
+    double out[ N_CHEM_OUTPUTS ];
+    step( params, in, ch4_prev, n2o_prev, out );
+
+    oh->TAU_OH.set( runToDate, unitval( out[ CO_TAU_OH ], U_YRS ) );
+    ch4->CH4.set( runToDate, unitval( out[ CO_CH4 ], U_PPBV_CH4 ) );
+    n2o->N2O.set( runToDate, unitval( out[ CO_N2O ], U_PPBV_N2O ) );
+    if( out[ CO_TAU_N2O ] == out[ CO_TAU_N2O ] ) {
+        n2o->TAU_N2O.set( runToDate, unitval( out[ CO_TAU_N2O ], U_YRS ) );
+    }
+    o3->O3.set( runToDate, unitval( out[ CO_O3 ], U_DU_O3 ) );
+
+    ch4_prev = out[ CO_CH4 ];
+    n2o_prev = out[ CO_N2O ];
+    lastDate = runToDate;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief One year of atmospheric chemistry
+ *  \param p   Parameters.
+ *  \param in  Inputs for the year, indexed by chem_input.
+ *  \param ch4 Previous year's CH4 concentration, ppbv.
+ *  \param n2o Previous year's N2O concentration, ppbv.
+ *  \param out Results, indexed by chem_output.  The N2O lifetime is NaN
+ *             if the N2O concentration was constrained.
+ *  \details The same calculations as the components' run() methods, in the
+ *           same order, so results are identical.
+ */
+void AtmosChemistry::step( const chem_params& p, const double in[],
+                           const double ch4, const double n2o, double out[] ) {
+    // OH lifetime, modified from Tanaka et al 2007 and Wigley et al 2002.
+    double toh = 0.0;
+    if( ch4 != p.M0_OH ) {  // if we are not at the first time
+        const double a = p.CCH4 * ( ( 1.0 * log( ch4 ) ) - log( p.M0_OH ) );
+        const double b = p.CNOX * ( in[ CI_NOX_OH ] - p.NOX0 );
+        const double c = p.CCO * ( in[ CI_CO_OH ] - p.CO0 );
+        const double d = p.CNMVOC * ( in[ CI_NMVOC_OH ] - p.NMVOC0 );
+        toh = a + b + c + d;
+    }
+    out[ CO_TAU_OH ] = p.TOH0 * exp( -toh );
+
+    // CH4, modified from Wigley et al, 2002
+    if( in[ CI_CH4_CONSTRAIN ] == in[ CI_CH4_CONSTRAIN ] ) {
+        out[ CO_CH4 ] = in[ CI_CH4_CONSTRAIN ];
+    } else {
+        const double emisTocon = ( in[ CI_CH4_EMISS ] + p.CH4N ) / p.UC_CH4;
+        const double soil_sink = ch4 / p.Tsoil;
+        const double strat_sink = ch4 / p.Tstrat;
+        const double oh_sink = ch4 / out[ CO_TAU_OH ];
+        const double dCH4 = emisTocon - soil_sink - strat_sink - oh_sink;
+        out[ CO_CH4 ] = ch4 + dCH4;
+    }
+
+    // N2O, Eqs. B7 and B8 in Ward and Mahowald, 2014
+    if( in[ CI_N2O_CONSTRAIN ] == in[ CI_N2O_CONSTRAIN ] ) {
+        out[ CO_N2O ] = in[ CI_N2O_CONSTRAIN ];
+        out[ CO_TAU_N2O ] = numeric_limits<double>::quiet_NaN();
+    } else {
+        out[ CO_TAU_N2O ] = p.TN2O0 * ( pow( n2o / p.N0, -0.05 ) );
+        const double dN2O = in[ CI_N2O_EMISS ] / p.UC_N2O - n2o / out[ CO_TAU_N2O ];
+        out[ CO_N2O ] = n2o + dN2O;
+    }
+
+    // Tropospheric ozone, modified from Tanaka et al 2007
+    out[ CO_O3 ] = ( 5*log( out[ CO_CH4 ] ) ) + ( 0.125*in[ CI_NOX_O3 ] ) + ( 0.0011*in[ CI_CO_O3 ] )
+        + ( 0.0033*in[ CI_NMVOC_O3 ] );
+}
+
+}
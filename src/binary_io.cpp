@@ -0,0 +1,161 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  binary_io.cpp
+ *  hector
+ *
+ */
+
+#include <cctype>
+#include <cstring>
+#include <fstream>
+
+#include <boost/lexical_cast.hpp>
+
+#include "binary_io.hpp"
+
+namespace Hector {
+
+using namespace std;
+
+const size_t BinaryReader::magic_len;
+
+//! Written in native byte order; reads back differently on other platforms
+static const uint32_t byte_order_mark = 0x01020304;
+
+//------------------------------------------------------------------------------
+/*! \brief Constructor: start the buffer with the file header
+ *  \param magic The magic string of the kind of file (magic_len characters).
+ *  \param version The format version.
+ */
+BinaryWriter::BinaryWriter( const char* magic, uint32_t version )
+: buf( magic, BinaryReader::magic_len )
+{
+    put_u32( byte_order_mark );
+    put_u32( version );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Append a string, as its length and bytes
+ */
+void BinaryWriter::put_string( const string& s ) {
+    put_u32( static_cast<uint32_t>( s.size() ) );
+    buf.append( s );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Append an array of doubles (without its length)
+ */
+void BinaryWriter::put_doubles( const vector<double>& x ) {
+    if( !x.empty() ) {
+        put( &x[ 0 ], x.size() * sizeof( double ) );
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Constructor
+ *  \param in The stream to read, positioned at the start of the file.
+ *  \param size The size of the file.
+ *  \param fileName The file name, for errors.
+ *  \param what The kind of file, for errors (e.g. "scenario bundle").
+ */
+BinaryReader::BinaryReader( istream& in, streamoff size,
+                            const string& fileName, const string& what )
+: in( in ), remaining( size ), fileName( fileName ), what( what )
+{
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Read and check the file header
+ *  \param magic The magic string of the kind of file expected.
+ *  \param version The format version expected.
+ *  \exception h_exception If the file is not of that kind, or was written by
+ *                         another version or platform.
+ */
+void BinaryReader::read_header( const char* magic, uint32_t version ) {
+    string What( what );
+    What[ 0 ] = static_cast<char>( toupper( What[ 0 ] ) );
+
+    char file_magic[ magic_len ];
+    get( file_magic, magic_len );
+    H_ASSERT( memcmp( file_magic, magic, magic_len ) == 0, fileName + " is not a " + what );
+    H_ASSERT( get_u32() == byte_order_mark,
+              What + " " + fileName + " was written on a platform with a different byte order" );
+    const uint32_t file_version = get_u32();
+    if( file_version != version ) {
+        H_THROW( What + " " + fileName + " has version "
+                 + boost::lexical_cast<string>( file_version ) + ", expected "
+                 + boost::lexical_cast<string>( version ) );
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Read n bytes
+ *  \exception h_exception If the file has fewer left, or could not be read.
+ */
+void BinaryReader::get( void* dest, size_t n ) {
+    if( remaining < static_cast<streamoff>( n ) ) {
+        truncated();
+    }
+    in.read( static_cast<char*>( dest ), n );
+    H_ASSERT( in, "Could not read " + what + " " + fileName );
+    remaining -= n;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Read a string written by BinaryWriter::put_string
+ */
+string BinaryReader::get_string() {
+    const uint32_t n = get_u32();
+    check( n, 1 );
+    string s( n, '\0' );
+    if( n ) {
+        get( &s[ 0 ], n );
+    }
+    return s;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Read an array of n doubles
+ */
+void BinaryReader::get_doubles( vector<double>& x, uint32_t n ) {
+    check( n, sizeof( double ) );
+    x.resize( n );
+    if( n ) {
+        get( &x[ 0 ], n * sizeof( double ) );
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Check that n items of the given size remain, before allocating them
+ */
+void BinaryReader::check( uint32_t n, size_t size ) const {
+    if( remaining / static_cast<streamoff>( size ) < n ) {
+        truncated();
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Report a read past the end of the file
+ */
+void BinaryReader::truncated() const {
+    string What( what );
+    What[ 0 ] = static_cast<char>( toupper( What[ 0 ] ) );
+    H_THROW( What + " " + fileName + " is truncated" );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Whether a file starts with the given magic string
+ */
+bool BinaryReader::has_magic( const string& fileName, const char* magic ) {
+    ifstream in( fileName.c_str(), ios::in | ios::binary );
+    char file_magic[ magic_len ];
+    return in.read( file_magic, magic_len ) &&
+        memcmp( file_magic, magic, magic_len ) == 0;
+}
+
+}
@@ -0,0 +1,145 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  binary_output_reader.cpp
+ *  hector
+ *
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <stdint.h>
+
+#include "binary_io.hpp"
+#include "binary_output_reader.hpp"
+#include "binary_output_visitor.hpp"
+
+namespace Hector {
+
+using namespace std;
+
+//! First bytes of every binary output file, as written by BinaryOutputVisitor
+static const char output_magic[] = "HECTORBO";
+
+//------------------------------------------------------------------------------
+/*! \brief Constructor: open a file and read its header
+ *
+ *  \param fileName The file to read.
+ *  \exception h_exception If the file could not be read, is not binary output,
+ *                         or was written by another version or platform.
+ */
+BinaryOutputReader::BinaryOutputReader( const string& fileName )
+: fileName( fileName ), in( fileName.c_str(), ios::in | ios::binary )
+{
+    if( !in ) {
+        H_THROW( "Could not open binary output file " + fileName + " error: " + strerror( errno ) );
+    }
+    in.seekg( 0, ios::end );
+    const streamoff size = in.tellg();
+    in.seekg( 0, ios::beg );
+
+    BinaryReader cur( in, size, fileName, "binary output file" );
+    cur.read_header( output_magic, BinaryOutputVisitor::version );
+
+    model_version = cur.get_string();
+    run_name = cur.get_string();
+
+    const uint32_t nvar = cur.get_u32();
+    cur.check( nvar, 3 * sizeof( uint32_t ) );
+    for( uint32_t i = 0; i < nvar; ++i ) {
+        components.push_back( cur.get_string() );
+        names.push_back( cur.get_string() );
+        var_units.push_back( cur.get_string() );
+    }
+
+    const uint32_t nrec = cur.get_u32();
+    cur.check( nrec, sizeof( double ) + 1 );
+    dates.resize( nrec );
+    spinup_flags.resize( nrec );
+    if( nrec ) {
+        cur.get( &dates[ 0 ], nrec * sizeof( double ) );
+        cur.get( &spinup_flags[ 0 ], nrec );
+    }
+
+    dataStart = in.tellg();
+    H_ASSERT( cur.left() == static_cast<streamoff>( nrec * nvar * sizeof( double ) ),
+              "Binary output file " + fileName + " has the wrong size" );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Find a variable in the dictionary
+ *
+ *  \param component The component that wrote the variable.
+ *  \param variable The variable name.
+ *  \return The variable's position in the dictionary.
+ *  \exception h_exception If the file has no such variable.
+ */
+size_t BinaryOutputReader::findVariable( const string& component, const string& variable ) const {
+    for( size_t i = 0; i < names.size(); ++i ) {
+        if( names[ i ] == variable && components[ i ] == component ) {
+            return i;
+        }
+    }
+    H_THROW( "Binary output file " + fileName + " has no variable " + component + "." + variable );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Read the value at a position in the data
+ */
+double BinaryOutputReader::readValue( size_t r, size_t var ) {
+    double x;
+    in.seekg( dataStart + static_cast<streamoff>( r * names.size() + var ) * sizeof( double ) );
+    in.read( reinterpret_cast<char*>( &x ), sizeof( x ) );
+    H_ASSERT( in, "Could not read binary output file " + fileName );
+    return x;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Read a variable over a range of dates
+ *
+ *  Only the requested values are read from the file.  Records without a value
+ *  for the variable give NaN.
+ *
+ *  \param var The variable's position in the dictionary (see findVariable).
+ *  \param startDate First date to read.
+ *  \param endDate Last date to read.
+ *  \param outDates Set to the dates read.
+ *  \param values Set to the values read.
+ *  \param inSpinup Read spinup records (whose dates are spinup steps) instead
+ *                  of the run.
+ */
+void BinaryOutputReader::read( size_t var, double startDate, double endDate,
+                               vector<double>& outDates, vector<double>& values,
+                               bool inSpinup ) {
+    H_ASSERT( var < names.size(), "variable index out of range" );
+    outDates.clear();
+    values.clear();
+    for( size_t r = 0; r < dates.size(); ++r ) {
+        if( ( spinup_flags[ r ] != 0 ) == inSpinup &&
+            dates[ r ] >= startDate && dates[ r ] <= endDate ) {
+            outDates.push_back( dates[ r ] );
+            values.push_back( readValue( r, var ) );
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Read every value of one record
+ *
+ *  \param r The record to read.
+ *  \param values Set to the record's values, in dictionary order.
+ */
+void BinaryOutputReader::readRecord( size_t r, vector<double>& values ) {
+    H_ASSERT( r < dates.size(), "record index out of range" );
+    values.resize( names.size() );
+    if( values.empty() ) return;
+    in.seekg( dataStart + static_cast<streamoff>( r * names.size() ) * sizeof( double ) );
+    in.read( reinterpret_cast<char*>( &values[ 0 ] ), values.size() * sizeof( double ) );
+    H_ASSERT( in, "Could not read binary output file " + fileName );
+}
+
+}
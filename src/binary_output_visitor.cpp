@@ -0,0 +1,88 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  binary_output_visitor.cpp
+ *  hector
+ *
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdint.h>
+
+#include "binary_io.hpp"
+#include "h_exception.hpp"
+#include "h_util.hpp"
+#include "binary_output_visitor.hpp"
+
+namespace Hector {
+
+using namespace std;
+
+const unsigned int BinaryOutputVisitor::version;
+
+//! First bytes of every binary output file
+static const char output_magic[] = "HECTORBO";
+
+//------------------------------------------------------------------------------
+/*! \brief Constructor
+ *  \param fileName The file to write the binary output to.
+ */
+BinaryOutputVisitor::BinaryOutputVisitor( const string& fileName )
+: RecordingOutputVisitor( fileName )
+{
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Destructor
+ *
+ *  Nothing is written unless close was called.
+ */
+BinaryOutputVisitor::~BinaryOutputVisitor() {
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Write the recorded results in the binary format
+ *  \exception h_exception If the file could not be written.
+ */
+void BinaryOutputVisitor::write() {
+    BinaryWriter buf( output_magic, version );
+    buf.put_string( MODEL_VERSION );
+    buf.put_string( run_name );
+
+    const size_t nvar = components.size();
+    buf.put_u32( static_cast<uint32_t>( nvar ) );
+    for( size_t i = 0; i < nvar; ++i ) {
+        buf.put_string( components[ i ] );
+        buf.put_string( names[ i ] );
+        buf.put_string( units[ i ] );
+    }
+
+    const size_t nrec = records.size();
+    buf.put_u32( static_cast<uint32_t>( nrec ) );
+    buf.put_doubles( dates );
+    for( size_t r = 0; r < nrec; ++r ) {
+        buf.put_u8( spinup[ r ] ? 1 : 0 );
+    }
+
+    ofstream out( fileName.c_str(), ios::out | ios::binary | ios::trunc );
+    out.write( buf.data().data(), buf.data().size() );
+    for( size_t r = 0; r < nrec; ++r ) {
+        records[ r ].resize( nvar, numeric_limits<double>::quiet_NaN() );
+        if( nvar ) {
+            out.write( reinterpret_cast<const char*>( &records[ r ][ 0 ] ), nvar * sizeof( double ) );
+        }
+    }
+    out.close();
+    if( !out ) {
+        H_THROW( "Could not write binary output file " + fileName + " error: " + strerror( errno ) );
+    }
+}
+
+}
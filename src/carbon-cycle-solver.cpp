@@ -15,6 +15,8 @@
 
 #include <math.h>
 #include <string>
+#include <algorithm>
+#include <numeric>
 
 // some boost headers generate warnings under clang; not our problem, ignore
 #pragma clang diagnostic push
@@ -27,12 +29,26 @@
 
 namespace Hector {
 
+//------------------------------------------------------------------------------
+/*! \brief Dormand-Prince 5 stepper with error control, sized for nc pools
+ */
+struct CarbonCycleSolver::ControlledStepper {
+    typedef boost::numeric::odeint::runge_kutta_dopri5<std::vector<double> > error_stepper_type;
+    typedef boost::numeric::odeint::result_of::make_controlled<error_stepper_type>::type controlled_stepper_type;
+
+    ControlledStepper( int nc, double eps_abs, double eps_rel ) : nc( nc ),
+        stepper( boost::numeric::odeint::make_controlled<error_stepper_type>( eps_abs, eps_rel ) ) { }
+
+    int nc;
+    controlled_stepper_type stepper;
+};
+
 //------------------------------------------------------------------------------
 /*! \brief Constructor
  */
 CarbonCycleSolver::CarbonCycleSolver() : nc( 0 ),
 eps_abs( 1.0e-6 ),eps_rel( 1.0e-6 ),
-dt( 0.3 )
+dt( 0.3 ), spinup_accel( 0 ), stepper( NULL )
 {
 }
 
@@ -41,6 +57,7 @@ dt( 0.3 )
  */
 CarbonCycleSolver::~CarbonCycleSolver()
 {
+    delete stepper;
 }
 
 //------------------------------------------------------------------------------
@@ -94,10 +111,14 @@ void CarbonCycleSolver::setData( const std::string &varName,
         if( varName == D_CCS_EPS_ABS ) {
             H_ASSERT( data.date == Core::undefinedIndex() , "date not allowed" );
             eps_abs = data.getUnitval(U_UNDEFINED);;
+            delete stepper;
+            stepper = NULL;
         }
         else if( varName == D_CCS_EPS_REL ) {
             H_ASSERT( data.date == Core::undefinedIndex() , "date not allowed" );
             eps_rel = data.getUnitval(U_UNDEFINED);;
+            delete stepper;
+            stepper = NULL;
         }
         else if( varName == D_CCS_DT ) {
             H_ASSERT( data.date == Core::undefinedIndex() , "date not allowed" );
@@ -107,6 +128,11 @@ void CarbonCycleSolver::setData( const std::string &varName,
             H_ASSERT( data.date == Core::undefinedIndex() , "date not allowed" );
             eps_spinup = data.getUnitval(U_PGC);
         }
+        else if( varName == D_SPINUP_ACCEL ) {
+            H_ASSERT( data.date == Core::undefinedIndex() , "date not allowed" );
+            spinup_accel = data.getUnitval(U_UNDEFINED);
+            H_ASSERT( spinup_accel >= 0, "spinup_accel must be >= 0" );
+        }
         else {
             H_LOG( logger, Logger::SEVERE ) << "Unknown variable " << varName << std::endl;
             H_THROW( "Unknown variable name while parsing "+ getComponentName() + ": "
@@ -235,6 +261,23 @@ void CarbonCycleSolver::run( const double tnew )
     }
     H_ASSERT( tnew > t, "solver tnew is not greater than t" );
 
+    if( core->concentrationDriven() && cmodel->atmosphere_prescribed( tnew ) ) {
+        // Atmospheric CO2 comes straight from its constraint; nothing to integrate
+        H_ASSERT( tnew - t == 1, "timestep must equal 1" );
+        cmodel->prescribe_atmosphere( tnew );
+        t = tnew;
+        return;
+    }
+
+    // The number of pools can change between runs (e.g., when biomes are
+    // created or deleted), so make sure our array matches the model.
+    nc = cmodel->ncpool();
+    c.resize(nc);
+    if( !stepper || stepper->nc != nc ) {
+        delete stepper;
+        stepper = new ControlledStepper( nc, eps_abs, eps_rel );
+    }
+
     // Get the initial state data from the box model. c will be filled in
     // Note that we rely on the box model to handle the units.  Inside the
     // solver we strip the unit values and work with raw numbers.
@@ -260,8 +303,9 @@ void CarbonCycleSolver::run( const double tnew )
             ODEEvalFunctor odeFunctor( cmodel, &t );
             try {
                 using namespace boost::numeric::odeint;
-                typedef runge_kutta_dopri5<std::vector<double> > error_stepper_type;
-                integrate_adaptive( make_controlled<error_stepper_type>( eps_abs, eps_rel ),
+                // Start each integration fresh, as a new stepper would
+                stepper->stepper.reset();
+                integrate_adaptive( boost::ref( stepper->stepper ),
                          odeFunctor, c, t_start, t_target, dt, odeFunctor );
             } catch( bad_derivative_exception& e ) {
                 stat = e.errorFlag;
@@ -325,6 +369,16 @@ bool CarbonCycleSolver::run_spinup( const int step )
 
         cmodel->getCValues( t, &c_original[0] );
         cmodel->record_state(t);
+
+        spinup_f.clear();
+        spinup_dg.clear();
+        spinup_df.clear();
+    }
+
+    if( spinup_accel ) {
+        spinup_x.resize( cmodel->nspinupstate() );
+        H_ASSERT( spinup_x.size(), "carbon model does not support accelerated spinup" );
+        cmodel->getSpinupState( &spinup_x[0] );
     }
 
     cmodel->getCValues( t, &c_old[0] );
@@ -343,6 +397,11 @@ bool CarbonCycleSolver::run_spinup( const int step )
     }
 
     bool spunup = ( max_dcdt < eps_spinup.value( U_PGC ) );
+    if( spinup_accel ) {
+        // The pools can be nearly steady while carbon is still moving
+        // between the ocean boxes, so the full spinup state must settle too
+        spunup = accelerate_spinup() && spunup;
+    }
 
     if( spunup ) {
         Logger& glog = core->getGlobalLogger();
@@ -364,6 +423,94 @@ bool CarbonCycleSolver::run_spinup( const int step )
     return spunup;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief      Extrapolate the spinup toward steady state
+ *  \returns    true if the spinup state changed by less than eps_spinup
+ *
+ *  Preindustrial steady state is a fixed point of the annual map x -> G(x)
+ *  that one spinup year applies to the model's spinup state.  Plain time
+ *  stepping converges at the rate of the slowest pool, which takes hundreds
+ *  of years.  Instead we use Anderson acceleration: with residuals
+ *  f = G(x) - x, the next state is the combination of the last
+ *  spinup_accel+1 images G(x) whose residual has minimum norm.  The weights
+ *  sum to one, so mass is conserved.  The spinup still ends with a plain
+ *  step, so the result is a state that time stepping leaves unchanged.
+ */
+bool CarbonCycleSolver::accelerate_spinup()
+{
+    const int ns = spinup_x.size();
+    std::vector<double> g( ns ), f( ns );
+    cmodel->getSpinupState( &g[0] );
+
+    double max_f = 0.0;
+    for( int i=0; i<ns; ++i ) {
+        f[ i ] = g[ i ] - spinup_x[ i ];
+        max_f = std::max( max_f, fabs( f[ i ] ) );
+    }
+
+    if( spinup_f.size() == f.size() ) {
+        std::vector<double> dg( ns ), df( ns );
+        for( int i=0; i<ns; ++i ) {
+            dg[ i ] = g[ i ] - spinup_g[ i ];
+            df[ i ] = f[ i ] - spinup_f[ i ];
+        }
+        spinup_dg.push_back( dg );
+        spinup_df.push_back( df );
+        if( int( spinup_df.size() ) > spinup_accel ) {
+            spinup_dg.pop_front();
+            spinup_df.pop_front();
+        }
+    }
+    spinup_g = g;
+    spinup_f = f;
+
+    if( max_f < eps_spinup.value( U_PGC ) || spinup_df.empty() ) {
+        return max_f < eps_spinup.value( U_PGC );
+    }
+
+    // Least-squares weights gamma minimizing |f - dF gamma|, by modified
+    // Gram-Schmidt QR of the residual differences
+    const int m = spinup_df.size();
+    std::vector<std::vector<double> > q( spinup_df.begin(), spinup_df.end() );
+    std::vector<double> r( m * m, 0.0 ), gamma( m );
+    for( int j=0; j<m; ++j ) {
+        const double norm0 = sqrt( std::inner_product( q[ j ].begin(), q[ j ].end(), q[ j ].begin(), 0.0 ) );
+        for( int k=0; k<j; ++k ) {
+            r[ k*m + j ] = std::inner_product( q[ k ].begin(), q[ k ].end(), q[ j ].begin(), 0.0 );
+            for( int i=0; i<ns; ++i ) q[ j ][ i ] -= r[ k*m + j ] * q[ k ][ i ];
+        }
+        r[ j*m + j ] = sqrt( std::inner_product( q[ j ].begin(), q[ j ].end(), q[ j ].begin(), 0.0 ) );
+        if( !( r[ j*m + j ] > 1e-10 * norm0 ) ) {
+            // History is (nearly) linearly dependent; start over from here
+            H_LOG( logger, Logger::NOTICE ) << "Spinup acceleration restarted" << std::endl;
+            spinup_dg.clear();
+            spinup_df.clear();
+            return false;
+        }
+        for( int i=0; i<ns; ++i ) q[ j ][ i ] /= r[ j*m + j ];
+    }
+    for( int j=m-1; j>=0; --j ) {
+        gamma[ j ] = std::inner_product( q[ j ].begin(), q[ j ].end(), f.begin(), 0.0 );
+        for( int k=j+1; k<m; ++k ) gamma[ j ] -= r[ j*m + k ] * gamma[ k ];
+        gamma[ j ] /= r[ j*m + j ];
+    }
+
+    std::vector<double> xnew( g );
+    for( int j=0; j<m; ++j ) {
+        for( int i=0; i<ns; ++i ) xnew[ i ] -= gamma[ j ] * spinup_dg[ j ][ i ];
+    }
+    if( *std::min_element( xnew.begin(), xnew.end() ) < 0.0 ) {
+        // Extrapolated too far; fall back to the plain time step
+        H_LOG( logger, Logger::NOTICE ) << "Spinup acceleration restarted" << std::endl;
+        spinup_dg.clear();
+        spinup_df.clear();
+        return false;
+    }
+
+    cmodel->setSpinupState( &xnew[0] );
+    return false;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief visitor accept code
  */
@@ -30,6 +30,7 @@ CH4Component::CH4Component() {
     CH4_emissions.name = CH4_COMPONENT_NAME;
     CH4.allowInterp( true );
     CH4.name = D_ATMOSPHERIC_CH4;
+    chemistry = 0;
 }
 
 //------------------------------------------------------------------------------
@@ -133,12 +134,18 @@ void CH4Component::prepareToRun() {
         M0 = CH4_constrain.get( oldDate );
     }
     CH4.set( oldDate, M0 );  // set the first year's value
+    chemistry = AtmosChemistry::find( core );
  }
 
 //------------------------------------------------------------------------------
 // documentation is inherited
 void CH4Component::run( const double runToDate ) {
 	H_ASSERT( !core->inSpinup() && runToDate-oldDate == 1, "timestep must equal 1" );
+    if( chemistry ) {
+        chemistry->run( runToDate );
+        oldDate = runToDate;
+        return;
+    }
 
     if ( CH4_constrain.size() && CH4_constrain.exists( runToDate ) ) {
         CH4.set( runToDate,  CH4_constrain.get( runToDate ) );
@@ -34,6 +34,8 @@
 #include "h_util.hpp"
 #include "simpleNbox.hpp"
 #include "avisitor.hpp"
+#include "results_collector_visitor.hpp"
+#include "output_subscription.hpp"
 
 namespace Hector {
 
@@ -55,20 +57,25 @@ Core::Core(Logger::LogLevel loglvl, bool echotoscreen, bool echotofile) :
     lastDate( -1.0),
     isInited( false ),
     do_spinup( true ),
+    conc_driven( false ),
     max_spinup( 2000 ),
-    in_spinup( false )
+    inputVersion( 0 ),
+    in_spinup( false ),
+    resultsCollector( 0 )
 {
     glog.open(string(MODEL_NAME), echotoscreen, echotofile, loglvl);
 }
 
 //------------------------------------------------------------------------------
 /*! \brief Destructor
- *  \note Memory for visitors is not handled by the core.
+ *  \note Memory for visitors is not handled by the core, except for the
+ *        results collector.
  */
 Core::~Core() {
     for( CNameComponentIterator it = modelComponents.begin(); it != modelComponents.end(); ++it ) {
         delete( *it ).second;
     }
+    delete resultsCollector;
 }
 
 //------------------------------------------------------------------------------
@@ -116,57 +123,7 @@ void Core::init() {
     temp = new TemperatureComponent();
     modelComponents[ temp->getComponentName() ] = temp;
 
-    temp = new HalocarbonComponent( CF4_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( C2F6_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( HFC23_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( HFC32_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( HFC4310_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( HFC125_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( HFC134a_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( HFC143a_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( HFC227ea_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( HFC245fa_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( SF6_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( HCFC22_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( CFC11_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( CFC12_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( CFC113_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( CFC114_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( CFC115_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( CCl4_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( CH3CCl3_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( HCFC141b_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( HCFC142b_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( halon1211_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( halon1301_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( halon2402_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( CH3Cl_COMPONENT_BASE );
-    modelComponents[ temp->getComponentName() ] = temp;
-    temp = new HalocarbonComponent( CH3Br_COMPONENT_BASE );
+    temp = new HalocarbonComponent();
     modelComponents[ temp->getComponentName() ] = temp;
 
     temp = new BlackCarbonComponent();
@@ -216,9 +173,15 @@ void Core::setData( const string& componentName, const string& varName,
             } else if( varName == D_DO_SPINUP ) {
                 H_ASSERT( data.date == undefinedIndex(), "date not allowed" );
                 do_spinup = (data.getUnitval(U_UNDEFINED) > 0);
+            } else if( varName == D_CONC_DRIVEN ) {
+                H_ASSERT( data.date == undefinedIndex(), "date not allowed" );
+                conc_driven = (data.getUnitval(U_UNDEFINED) > 0);
             } else if( varName == D_MAX_SPINUP ) {
                 H_ASSERT( data.date == undefinedIndex(), "date not allowed" );
                 max_spinup = data.getUnitval(U_UNDEFINED);
+            } else if( varName == D_OUTPUT_VARIABLES ) {
+                H_ASSERT( data.date == undefinedIndex(), "date not allowed" );
+                outputVariables = OutputSubscription::parse( data.value_str );
             } else {
                 H_THROW( "Unknown variable name while parsing "+ getComponentName() + ": "
                         + varName );
@@ -228,6 +191,7 @@ void Core::setData( const string& componentName, const string& varName,
         }
     } else {    // data is not intended for us
         IModelComponent* component = getComponentByName( componentName );
+        const bool alias = componentAliases.count( componentName ) > 0;
 
         if( varName == D_ENABLED ) {
             // The core intercepts "enabled=xxx" lines to mark components as disabled
@@ -241,12 +205,38 @@ void Core::setData( const string& componentName, const string& varName,
                 H_LOG( glog, Logger::WARNING ) << "Disabling output for " << componentName << endl;
                 disabledOutputComponents.push_back( componentName );
             }
+        } else if( alias ) {
+            // Route to the component behind the alias, telling it which
+            // alias the data came from
+            component->setData( componentName + SNBOX_PARSECHAR + varName, data );
+            bumpInputVersion( varName );
         } else {
             component->setData( varName, data );   // route data
+            bumpInputVersion( varName );
         }
     }
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Record that an input has been set
+ *  \param inputName Name of the input, with or without a biome prefix.
+ */
+void Core::bumpInputVersion( const string& inputName ) {
+    const size_t sep = inputName.rfind( SNBOX_PARSECHAR );
+    inputVersions[ sep == string::npos ? inputName : inputName.substr( sep + 1 ) ] = ++inputVersion;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Input version at which an input was last set
+ *  \param inputName Name of the input, without a biome prefix.
+ *  \returns The value of getInputVersion() just after the input was last
+ *           set, or 0 if it never has been.
+ */
+unsigned long Core::getInputVersion( const string& inputName ) const {
+    map<string, unsigned long>::const_iterator it = inputVersions.find( inputName );
+    return it == inputVersions.end() ? 0 : it->second;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Add a visitor which will be called after each model time-step.
  *
@@ -263,6 +253,33 @@ void Core::addVisitor( AVisitor* visitor ) {
     modelVisitors.push_back( visitor );
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Store the given variables for every year of the run.
+ *
+ *  Creates a ResultsCollectorVisitor, owned by the core, and adds it to the
+ *  visitors.  Its columns can be read with getResults.  Calling this again
+ *  replaces the collector (and discards its results).
+ *
+ *  \param vars The variables (capabilities) to store.
+ *  \return The collector.
+ *  \exception h_exception If the core has not been set up, or a variable
+ *                         is not a capability of any component.
+ */
+ResultsCollectorVisitor* Core::collectResults( const vector<string>& vars ) {
+    H_ASSERT( isInited, "collectResults not available until core is initialized" );
+    ResultsCollectorVisitor* collector = new ResultsCollectorVisitor( this, vars );
+
+    VisitorIterator it = find( modelVisitors.begin(), modelVisitors.end(), resultsCollector );
+    if( it != modelVisitors.end() ) {
+        *it = collector;
+    } else {
+        modelVisitors.push_back( collector );
+    }
+    delete resultsCollector;
+    resultsCollector = collector;
+    return collector;
+}
+
 
 //------------------------------------------------------------------------------
 /*! \brief Prepare model components to run
@@ -294,16 +311,22 @@ void Core::prepareToRun(void)
         // 1. Go through the list of components that have been disabled and remove them
         // from the capability and component lists
 
+        // Disabling an alias only removes the capabilities registered under
+        // it; the component behind it keeps running.
+
         for( vector<string>::iterator it=disabledComponents.begin(); it != disabledComponents.end(); ++it ) {
             H_LOG( glog, Logger::WARNING ) << "Disabling " << *it << endl;
-            IModelComponent * mcomp = getComponentByName( *it );
-            mcomp->shutDown();
-            delete mcomp;
-            modelComponents.erase( *it );
+            if( !componentAliases.count( *it ) ) {
+                IModelComponent * mcomp = getComponentByName( *it );
+                mcomp->shutDown();
+                delete mcomp;
+                modelComponents.erase( *it );
+            }
 
             componentMapIterator it2 = componentCapabilities.begin();
             while( it2 != componentCapabilities.end() ) {
-                if( it2->second==*it ) {
+                map<string, string>::const_iterator alias = componentAliases.find( it2->second );
+                if( it2->second==*it || ( alias != componentAliases.end() && alias->second==*it ) ) {
                     H_LOG( glog, Logger::DEBUG) << "--erasing " << it2->first << " " << it2->second << endl;
                     componentCapabilities.erase( it2++ );
                 } else {
@@ -350,8 +373,11 @@ void Core::prepareToRun(void)
     }
 
     // ------------------------------------
-    // 5. Spin up the model
-    if( do_spinup ) {
+    // 5. Spin up the model.  Only the carbon cycle spins up, so this can be
+    // skipped if it won't be run.
+    if( do_spinup && !spinupNeeded() ) {
+        H_LOG( glog, Logger::NOTICE) << "Concentration-driven run with CO2 prescribed throughout; skipping spinup" << endl;
+    } else if( do_spinup ) {
         H_LOG( glog, Logger::NOTICE) << "Spinning up model..." << endl;
         run_spinup();
     } else {
@@ -359,6 +385,26 @@ void Core::prepareToRun(void)
     } // if
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Whether the carbon cycle must be spun up
+ *  \details It needn't be in a concentration-driven run where atmospheric CO2
+ *           is prescribed in every year from the start date to the end
+ *           date, because the carbon cycle is never run.
+ */
+bool Core::spinupNeeded()
+{
+    if( !conc_driven ) {
+        return true;
+    }
+    CarbonCycleModel* cmodel = dynamic_cast<CarbonCycleModel*>( getComponentByCapability( D_ATMOSPHERIC_C ) );
+    for( double t = startDate + 1.0; cmodel && t <= endDate; t += 1.0 ) {
+        if( !cmodel->atmosphere_prescribed( t ) ) {
+            return true;
+        }
+    }
+    return !cmodel;
+}
+
 bool Core::run_spinup()
 {
     in_spinup = true;
@@ -439,6 +485,8 @@ void Core::run(double runtodate) {
         for( NameComponentIterator it = modelComponents.begin(); it != modelComponents.end(); ++it ) {
             ( *it ).second->run( currDate );
         }
+        // Visitors may ask for values at any date through this one
+        lastDate = currDate;
 
         // Let visitors attempt to collect data if necessary
         for( VisitorIterator visitorIt = modelVisitors.begin(); visitorIt != modelVisitors.end(); ++visitorIt ) {
@@ -458,7 +506,7 @@ void Core::reset(double resetdate)
     bool rerun_spinup = false;
     H_LOG(glog, Logger::NOTICE) << "Resetting model to t= " << resetdate << endl;
     if(resetdate < getStartDate()) {
-        if(do_spinup) {
+        if(do_spinup && spinupNeeded()) {
             rerun_spinup = true;
             resetdate = 0;      // t=0 is the first iteration of the spinup.
             H_LOG(glog, Logger::NOTICE) << "Rerunning spinup.\n";
@@ -486,6 +534,9 @@ void Core::reset(double resetdate)
         lastDate = getStartDate();
     else
         lastDate = resetdate;
+
+    if(resultsCollector)
+        resultsCollector->reset(lastDate);
 }
 
 
@@ -509,7 +560,9 @@ void Core::shutDown()
  */
 IModelComponent* Core::getComponentByName( const string& componentName ) const
 {
-    CNameComponentIterator it = modelComponents.find( componentName );
+    map<string, string>::const_iterator alias = componentAliases.find( componentName );
+    CNameComponentIterator it = modelComponents.find( alias == componentAliases.end() ?
+                                                      componentName : alias->second );
 
     // throw an exception for an unknown component
     string err = "Unknown model component: " + componentName;
@@ -568,6 +621,24 @@ void Core::registerCapability(const string& capabilityName, const string& compon
     }
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Register another name for a component.
+ *
+ *  \details A component that does the work of several (e.g., all of the
+ *           halocarbons) can keep their names as aliases.  Capabilities and
+ *           inputs may be registered under an alias; messages for them are
+ *           routed to the component.  Data set on an alias through setData
+ *           is passed on as `alias.variable`, and an alias can be disabled,
+ *           or have its output disabled, separately from the component.
+ *  \param alias The name to register.
+ *  \param componentName The name of the component it refers to.
+ */
+void Core::registerComponentAlias( const string& alias, const string& componentName ) {
+    H_ASSERT( !isInited, "registerComponentAlias not available after core is initialized" );
+    H_ASSERT( !modelComponents.count( alias ), "alias " + alias + " is already a component name" );
+    componentAliases[ alias ] = componentName;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Register a component as accepting a certain input
  *
@@ -676,6 +747,7 @@ unitval Core::sendMessage( const std::string& message,
         }
         for(componentMapIterator it=itpr.first; it != itpr.second; ++it)
             getComponentByName(it->second)->sendMessage(message, datum, info);
+        bumpInputVersion(datum_capability);
 
         return info.value_unitval;
     }
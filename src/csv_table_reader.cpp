@@ -12,6 +12,12 @@
  *
  */
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
 #include <vector>
 
 // some boost headers generate warnings under clang; not our problem, ignore
@@ -20,89 +26,448 @@
 #include <boost/lexical_cast.hpp>
 #pragma clang diagnostic pop
 
-#include <boost/algorithm/string/split.hpp>
-#include <boost/algorithm/string/trim.hpp>
 #include <errno.h>
+#include <sys/stat.h>
 
 #include "core.hpp"
 #include "message_data.hpp"
 #include "csv_table_reader.hpp"
+#include "scenario_bundle.hpp"
 
 namespace Hector {
 
 using namespace std;
 
+//------------------------------------------------------------------------------
+/*! \brief Narrow [begin, end) to exclude surrounding white space
+ */
+static void trim_cell( const string& text, size_t& begin, size_t& end ) {
+    while( begin < end && isspace( static_cast<unsigned char>( text[ begin ] ) ) ) {
+        ++begin;
+    }
+    while( end > begin && isspace( static_cast<unsigned char>( text[ end-1 ] ) ) ) {
+        --end;
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Convert a whole cell to a number
+ *
+ *  \return Whether the cell holds exactly one number.
+ */
+static bool parse_number( const char* begin, const char* end, double& value ) {
+    // strtod needs a terminated string; cells are short
+    char buf[ 64 ];
+    const size_t len = end - begin;
+    string longcell;
+    const char* str = buf;
+    if( len < sizeof( buf ) ) {
+        copy( begin, end, buf );
+        buf[ len ] = '\0';
+    } else {
+        longcell.assign( begin, end );
+        str = longcell.c_str();
+    }
+    char* parsed;
+    value = strtod( str, &parsed );
+    return len > 0 && parsed == str + len;
+}
+
+const size_t CSVTableReader::max_cached_tables;
+std::map<std::string, CSVTableReader::cache_entry> CSVTableReader::tableCache;
+unsigned long CSVTableReader::cacheClock = 0;
+std::mutex CSVTableReader::tableCacheMutex;
+
+//------------------------------------------------------------------------------
+/*! \brief Whether a file modified at the given time (ns since the epoch) could
+ *         be modified again without its times changing
+ *
+ *  File systems update times at a coarse granularity (up to two seconds).
+ */
+static bool is_racy( long long mtime_ns ) {
+    const long long now_ns = chrono::duration_cast<chrono::nanoseconds>(
+        chrono::system_clock::now().time_since_epoch() ).count();
+    return now_ns - mtime_ns < 2000000000LL;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Constructor
  *
- *  Attempts to open the given file name.
+ *  Checks that the given file exists; it is not read until processed.
  *
  *  \param fileName The name of a csv file to read from.
- *  \exception h_exception If there were errors when opening the file.
+ *  \param contents The contents of the file, if it is not to be read (optional).
+ *  \exception h_exception If the file does not exist.
  */
-CSVTableReader::CSVTableReader( const string& fileName )
-:fileName( fileName )
+CSVTableReader::CSVTableReader( const string& fileName, shared_ptr<const string> contents )
+:fileName( fileName ), contents( contents )
 {
-    // allow exceptions from bad io operations
-    tableInputStream.exceptions( ifstream::failbit | ifstream:: badbit );
-
-    try {
-        // attempt to open the file
-        tableInputStream.open( fileName.c_str() );
-    } catch( ifstream::failure e ) {
+    if( contents ) {
+        return;
+    }
+    struct stat st;
+    if( stat( fileName.c_str(), &st ) != 0 ) {
         // the macro errno in combination with strerror seem to be much more
         // informative than error message from the exception
         string errorStr = "Could not open csv file: "+fileName+" error: "+strerror(errno);
         H_THROW( errorStr );
     }
-    lineNum = 0;
 }
 
 //------------------------------------------------------------------------------
 /*! \brief Destructor
  *
- *  Closes the input stream.
+ *  The table stays in the cache.
  */
 CSVTableReader::~CSVTableReader() {
-    try {
-        tableInputStream.close();
-    } catch( ifstream::failure e ) {
-        // ignoring close errors
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Empty the table cache
+ *
+ *  Tables are re-read from disk the next time they are processed.
+ */
+void CSVTableReader::clearCache() {
+    lock_guard<mutex> lock( tableCacheMutex );
+    tableCache.clear();
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Describe the file as it is now
+ *  \exception h_exception If the file does not exist.
+ */
+CSVTableReader::file_stamp CSVTableReader::stampFile() const {
+    struct stat st;
+    if( stat( fileName.c_str(), &st ) != 0 ) {
+        string errorStr = "Could not open csv file: "+fileName+" error: "+strerror(errno);
+        H_THROW( errorStr );
     }
+    file_stamp stamp;
+    stamp.size = st.st_size;
+    stamp.inode = st.st_ino;
+#if defined( __APPLE__ )
+    stamp.mtime_ns = st.st_mtimespec.tv_sec * 1000000000LL + st.st_mtimespec.tv_nsec;
+    stamp.ctime_ns = st.st_ctimespec.tv_sec * 1000000000LL + st.st_ctimespec.tv_nsec;
+#elif defined( _WIN32 )
+    stamp.mtime_ns = st.st_mtime * 1000000000LL;
+    stamp.ctime_ns = st.st_ctime * 1000000000LL;
+#else
+    stamp.mtime_ns = st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+    stamp.ctime_ns = st.st_ctim.tv_sec * 1000000000LL + st.st_ctim.tv_nsec;
+#endif
+    return stamp;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Get the parsed table for this file, reading it if necessary
+ *
+ *  The cached table is used if the file's stamp has not changed and, for a
+ *  recently modified file, its contents have not either.  Otherwise the
+ *  table is re-read.  The least recently used table is dropped when the
+ *  cache is full.  A table given as contents is parsed once, and not cached.
+ */
+shared_ptr<const CSVTableReader::csv_table> CSVTableReader::getTable() {
+    if( contents ) {
+        if( !contentsTable ) {
+            contentsTable = parseTable();
+        }
+        return contentsTable;
+    }
+
+    const file_stamp stamp = stampFile();
+
+    shared_ptr<const csv_table> unsure;
+    {
+        lock_guard<mutex> lock( tableCacheMutex );
+        map<string, cache_entry>::iterator cached = tableCache.find( fileName );
+        if( cached != tableCache.end() && cached->second.stamp == stamp ) {
+            if( !cached->second.racy ) {
+                cached->second.lastUse = ++cacheClock;
+                return cached->second.table;
+            }
+            unsure = cached->second.table;
+        }
+    }
+
+    if( unsure ) {
+        string text;
+        readFile( text );
+        if( text == unsure->text ) {
+            lock_guard<mutex> lock( tableCacheMutex );
+            map<string, cache_entry>::iterator cached = tableCache.find( fileName );
+            if( cached != tableCache.end() && cached->second.table == unsure ) {
+                cached->second.racy = is_racy( stamp.mtime_ns );
+                cached->second.lastUse = ++cacheClock;
+            }
+            return unsure;
+        }
+    }
+
+    // parse without holding the lock so that tables can be loaded in parallel
+    cache_entry entry;
+    entry.stamp = stamp;
+    entry.racy = is_racy( stamp.mtime_ns );
+    entry.table = parseTable();
+
+    lock_guard<mutex> lock( tableCacheMutex );
+    entry.lastUse = ++cacheClock;
+    tableCache[ fileName ] = entry;
+    while( tableCache.size() > max_cached_tables ) {
+        map<string, cache_entry>::iterator oldest = tableCache.begin();
+        for( map<string, cache_entry>::iterator it = tableCache.begin(); it != tableCache.end(); ++it ) {
+            if( it->second.lastUse < oldest->second.lastUse ) {
+                oldest = it;
+            }
+        }
+        // readers still using the table keep it alive
+        tableCache.erase( oldest );
+    }
+    return entry.table;
+}
 
 //------------------------------------------------------------------------------
-/*! \brief Helper function
+/*! \brief Load tables into the cache on a few threads
  *
- *  Get the next line that doesn't start with a semicolon.
+ *  Each distinct file is parsed (if it is not already cached) by one of up
+ *  to four worker threads.  Errors are ignored here; they are reported when
+ *  the table is processed.
+ *
+ *  \param fileNames The files to load; may contain duplicates.
  */
-string CSVTableReader::csv_getline() {
-    string s;
-    bool semicolon = true;
-    bool hash = true;
+void CSVTableReader::preload( const vector<string>& fileNames ) {
+    vector<string> names( fileNames );
+    sort( names.begin(), names.end() );
+    names.erase( unique( names.begin(), names.end() ), names.end() );
+
+    atomic<size_t> next( 0 );
+    auto load = [&names, &next]() {
+        for( size_t i = next++; i < names.size(); i = next++ ) {
+            try {
+                CSVTableReader reader( names[ i ] );
+                reader.getTable();
+            } catch( h_exception& e ) {
+                // reported when processed
+            }
+        }
+    };
+
+    const size_t nthreads = min( names.size(),
+                                 size_t( max( 1u, min( 4u, thread::hardware_concurrency() ) ) ) );
+    if( nthreads <= 1 ) {
+        load();
+        return;
+    }
+    vector<thread> workers;
+    for( size_t i = 1; i < nthreads; ++i ) {
+        workers.push_back( thread( load ) );
+    }
+    load();
+    for( size_t i = 0; i < workers.size(); ++i ) {
+        workers[ i ].join();
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Read the whole file (or take the contents given)
+ *  \exception h_exception If the file could not be read.
+ */
+void CSVTableReader::readFile( string& text ) const
+{
+    if( contents ) {
+        text = *contents;
+        return;
+    }
+    try {
+        ifstream tableInputStream;
+        // allow exceptions from bad io operations
+        tableInputStream.exceptions( ifstream::failbit | ifstream:: badbit );
+        tableInputStream.open( fileName.c_str(), ios::in | ios::binary );
+        tableInputStream.seekg( 0, ios::end );
+        text.resize( static_cast<size_t>( tableInputStream.tellg() ) );
+        tableInputStream.seekg( 0, ios::beg );
+        if( !text.empty() ) {
+            tableInputStream.read( &text[ 0 ], text.size() );
+        }
+    } catch( const ifstream::failure& e ) {
+        string errorStr = "I/O exception while processing "+fileName+" error: "+strerror(errno);
+        H_THROW( errorStr );
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Read the CSV file and locate its cells
+ *
+ *  The file is read in one go.  Lines starting with a semicolon or hash are
+ *  comments.  The first other line is the header, giving the column names;
+ *  the first column is the index.  Each subsequent row is either a UNITS row,
+ *  whose cells are the units of each column, or a data row whose first
+ *  column is its time series index (or, for a table of named rows, its name).
+ *  Blank lines (including a stray carriage return) are skipped, and extra
+ *  white space around cells is ignored.
+ *
+ *  \exception h_exception For any I/O errors or a missing header.
+ */
+shared_ptr<const CSVTableReader::csv_table> CSVTableReader::parseTable()
+{
+    std::shared_ptr<csv_table> table( new csv_table );
+    string& text = table->text;
+    readFile( text );
 
-    while( ( semicolon || hash ) && !tableInputStream.eof() && tableInputStream.peek() != -1 ) {
-        getline( tableInputStream, s ); //TODO: this depends on Unix line endings
+    vector<pair<size_t, size_t> > row;
+    int lineNum = 0;
+    bool have_header = false;
+    table->bad_index_line = 0;
+    size_t pos = 0;
+    while( pos < text.size() ) {
+        size_t eol = text.find( '\n', pos );
+        if( eol == string::npos ) {
+            eol = text.size();
+        }
+        const size_t bol = pos;
+        pos = eol + 1;
         ++lineNum;
-        semicolon = s[ 0 ] == ';';
-        hash = s[ 0 ] == '#';
+
+        if( text[ bol ] == ';' || text[ bol ] == '#' ) {
+            continue;
+        }
+        // Ignore blank lines. A stray windows line ending which may have made
+        // its way in from a mixed line ending file can be skipped as well.
+        if( bol == eol || text[ bol ] == '\r' ) {
+            if( !have_header ) {
+                H_THROW( "line empty" );
+            }
+            continue;
+        }
+
+        // split the line into trimmed cells
+        row.clear();
+        size_t begin = bol;
+        while( true ) {
+            size_t end = text.find( ',', begin );
+            if( end == string::npos || end > eol ) {
+                end = eol;
+            }
+            size_t b = begin, e = end;
+            trim_cell( text, b, e );
+            row.push_back( make_pair( b, e ) );
+            if( end == eol ) {
+                break;
+            }
+            begin = end + 1;
+        }
+
+        if( !have_header ) {
+            have_header = true;
+            table->header = text.substr( bol, eol - bol );
+            for( size_t col = 0; col < row.size(); ++col ) {
+                table->colnames.push_back( text.substr( row[ col ].first, row[ col ].second - row[ col ].first ) );
+            }
+            table->ncol = row.size();
+            continue;
+        }
+
+        const string first = text.substr( row[ 0 ].first, row[ 0 ].second - row[ 0 ].first );
+        const bool units_row = first == "UNITS";
+        double index = 0.0;
+        if( !units_row && !parse_number( text.data() + row[ 0 ].first,
+                                         text.data() + row[ 0 ].second, index )
+            && table->bad_index_line == 0 ) {
+            table->bad_index_line = lineNum;
+        }
+        table->lines.push_back( lineNum );
+        table->units_row.push_back( units_row );
+        table->index.push_back( index );
+        row.resize( table->ncol, make_pair( size_t( 0 ), size_t( 0 ) ) );
+        table->cells.insert( table->cells.end(), row.begin(), row.end() );
+    }
+    if( !have_header ) {
+        H_THROW( "line empty" );
+    }
+    return table;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Get a column of the table converted to numbers
+ *
+ *  The column is converted the first time it is requested and kept with the
+ *  table.
+ *
+ *  \exception h_exception If a (non-blank) value is not a number.
+ */
+shared_ptr<const CSVTableReader::csv_table::column>
+CSVTableReader::csv_table::getColumn( size_t col, const string& fileName ) const {
+    lock_guard<mutex> lock( columnsMutex );
+    map<size_t, shared_ptr<const column> >::const_iterator found = columns.find( col );
+    if( found != columns.end() ) {
+        return found->second;
+    }
+
+    std::shared_ptr<column> converted( new column );
+    const size_t nrow = units_row.size();
+    converted->units.resize( nrow );
+    converted->values.resize( nrow, 0.0 );
+    converted->blank.resize( nrow, true );
+    string unitsLabel;
+    for( size_t i = 0; i < nrow; ++i ) {
+        const pair<size_t, size_t>& cell = cells[ i * ncol + col ];
+        if( units_row[ i ] ) {
+            // this row of the table is specifying units for all columns
+            // we only need to keep track of the value for the column of interest
+            unitsLabel = text.substr( cell.first, cell.second - cell.first );
+        } else if( cell.second > cell.first ) {      // ignore blanks
+            if( !parse_number( text.data() + cell.first, text.data() + cell.second,
+                               converted->values[ i ] ) ) {
+                H_THROW( "Could not convert value "+text.substr( cell.first, cell.second - cell.first )
+                        +" on line "+boost::lexical_cast<string>( lines[ i ] )+" of "+fileName );
+            }
+            converted->blank[ i ] = false;
+        }
+        converted->units[ i ] = unitsLabel;
+    }
+    columns[ col ] = converted;
+    return converted;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Find the column holding varName
+ *
+ *  The first column is not considered because that should be the index column.
+ *
+ *  \exception h_exception If there is no such column.
+ */
+size_t CSVTableReader::findColumn( const csv_table& table, const string& varName ) const {
+    for( size_t col = 1; col < table.colnames.size(); ++col ) {
+        if( table.colnames[ col ] == varName ) {
+            return col;
+        }
+    }
+    H_THROW( "Could not find a column for "+varName+" in "+fileName+" header="+table.header );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Check that every data row of a time series table has a date
+ *
+ *  \exception h_exception If the index of a row is not a number.
+ */
+void CSVTableReader::checkIndex( const csv_table& table ) const {
+    if( table.bad_index_line == 0 ) {
+        return;
     }
-    return s;
+    const size_t row = find( table.lines.begin(), table.lines.end(), table.bad_index_line )
+        - table.lines.begin();
+    const pair<size_t, size_t>& cell = table.cells[ row * table.ncol ];
+    H_THROW( "Could not convert index to double on line: "+boost::lexical_cast<string>( table.bad_index_line )
+            +", exception: bad index "+table.text.substr( cell.first, cell.second - cell.first ) );
 }
 
 //------------------------------------------------------------------------------
 /*! \brief Process the CSV file looking for the given varName and route the data
  *         into the core.
  *
- *  The input stream will be reset to allow to processing multiple times from
- *  this reader.  Next the header row is read and searched to find the column
- *  which varName is contained in.  Then each row of the table is read.  Should the
- *  the first column be UNITS it will use the row to set the units string to pass
- *  along with read data to provide units checking.  Otherwise it will assume
- *  the first column is the time series index and consistent columns for each
- *  row. Each value will be routed through the core as rows are read.  Extra
- *  white space will be removed before sending the value into the core.
+ *  The (cached) table's header is searched to find the column which varName is
+ *  contained in.  Then each value in that column is routed through the core,
+ *  with the units given by the most recent UNITS row (if any).  Blank values
+ *  are skipped.
  *
  *  \param core A pointer to the model core to route data through.
  *  \param componentName The model component to set varName in.
@@ -115,86 +480,126 @@ string CSVTableReader::csv_getline() {
 void CSVTableReader::process( Core* core, const string& componentName,
                              const string& varName )
 {
-    using namespace boost;
-    try {
-        // reset the stream in case we are re-reading from this stream
-        tableInputStream.clear();
-        tableInputStream.seekg( 0, ifstream::beg );
-        lineNum = 0;
-
-        string line;
-        vector<string> row;
-        string unitsLabel;
-        size_t columnIndex = 0; // code for "not found", takes advantage of skipping col==0 in the loop below.
-
-        // read the header line and attempt to find varName. The first column is
-        // not considered because that should be the index column.
-        line = csv_getline();
-        H_ASSERT( !line.empty(), "line empty" );
-        split( row, line, is_any_of( "," ) );
-//        const int headerRowSize = row.size();
-        for( size_t col = 1; col < row.size() && columnIndex == 0; ++col ) {
-            // ignore white space before comparing variable names
-            trim( row[ col ] );
-            if( row[ col ] == varName ) {
-                columnIndex = col;
-            }
+    shared_ptr<const csv_table> table = getTable();
+    checkIndex( *table );
+    shared_ptr<const csv_table::column> column =
+        table->getColumn( findColumn( *table, varName ), fileName );
+    const string* unitsLabel = 0;
+    unit_types units = U_UNDEFINED;
+    for( size_t i = 0; i < column->values.size(); ++i ) {
+        if( column->blank[ i ] ) {
+            continue;
         }
-        if( columnIndex == 0 ) {
-            H_THROW( "Could not find a column for "+varName+" in "+fileName+" header="+line );
+        if( !unitsLabel || *unitsLabel != column->units[ i ] ) {
+            unitsLabel = &column->units[ i ];
+            // no units means the component's expected units
+            units = unitsLabel->empty() ? U_UNDEFINED : unitval::parseUnitsName( *unitsLabel );
         }
+        // route the data to the appropriate model component
+        core->setData( componentName, varName,
+                       message_data( table->index[ i ], unitval( column->values[ i ], units ) ) );
+    }
+    // h_exceptions from setData should just be passed along
+}
 
-        // we are all set to process the table
-        // note that getline sets the fail bit when it hits eof which is not what
-        // want, a work around is to check peek
-        int lines_read = 0;
-        while( !tableInputStream.eof() && tableInputStream.peek() != -1 ) {
-            // read the next row to process
-            line = csv_getline();
-            lines_read++;
+//------------------------------------------------------------------------------
+/*! \brief Add the values of varName to a scenario bundle instead of routing them.
+ *
+ *  Each run of values with the same units becomes one series in the bundle.
+ *
+ *  \param bundle The bundle to add to.
+ *  \param componentName The model component the values are for.
+ *  \param varName The variable name to look for in the CSV file.
+ *  \exception h_exception As for process.
+ */
+void CSVTableReader::record( ScenarioBundle& bundle, const string& componentName,
+                             const string& varName )
+{
+    shared_ptr<const csv_table> table = getTable();
+    checkIndex( *table );
+    shared_ptr<const csv_table::column> column =
+        table->getColumn( findColumn( *table, varName ), fileName );
 
-            // Ignore blank lines. A stray windows line ending which may have made
-            // its way in from a mixed line ending file can be skipped as well.
-            if( line.empty() || line[ 0 ] == '\r' ) {
-                continue;
-            }
+    vector<double> dates, values;
+    const string* unitsLabel = 0;
+    for( size_t i = 0; i < column->values.size(); ++i ) {
+        if( column->blank[ i ] ) {
+            continue;
+        }
+        if( unitsLabel && *unitsLabel != column->units[ i ] ) {
+            bundle.addSeries( componentName, varName, *unitsLabel, dates, values );
+            dates.clear();
+            values.clear();
+        }
+        unitsLabel = &column->units[ i ];
+        dates.push_back( table->index[ i ] );
+        values.push_back( column->values[ i ] );
+    }
+    if( unitsLabel ) {
+        bundle.addSeries( componentName, varName, *unitsLabel, dates, values );
+    }
+}
 
-            split( row, line, is_any_of( "," ) );
-
-            // we should have a constant number of columns
-//TODO: figure this out for VS!  H_ASSERT( columnIndex < row.size() && headerRowSize == row.size(), "varying columns in data line "+ boost::lexical_cast<std::string>( lines_read ) );
-
-            // remove extra white space from the table value
-            trim( row[ 0 ] );
-            trim( row[ columnIndex ] );
-
-            if( row[ 0 ] == "UNITS" ) {
-                // this row of the table is specifying units for all columns
-                // we only need to keep track of the value for the column of interest
-                unitsLabel = row[ columnIndex ];
-            } else {
-                // this row is a regular row of data
-                // the first column is assumed to be the index
-                double tseriesIndex = lexical_cast<double>( row[ 0 ] );
-
-                // route the data to the appropriate model component
-                if( !row[ columnIndex ].empty() ) {      // ignore blanks
-                    message_data data( row[ columnIndex ] );
-                    data.date = tseriesIndex;
-                    data.units_str = unitsLabel;
-                    core->setData( componentName, varName, data );
-                }
-            }
+//------------------------------------------------------------------------------
+/*! \brief The name of each data row, for a table whose rows are named rather
+ *         than dated
+ *
+ *  The names are the (trimmed) first cells of the rows other than UNITS rows,
+ *  in file order.
+ *
+ *  \exception h_exception For any I/O errors or improper formatting.
+ */
+vector<string> CSVTableReader::getRowNames() {
+    shared_ptr<const csv_table> table = getTable();
+    vector<string> names;
+    for( size_t i = 0; i < table->units_row.size(); ++i ) {
+        if( !table->units_row[ i ] ) {
+            const pair<size_t, size_t>& cell = table->cells[ i * table->ncol ];
+            names.push_back( table->text.substr( cell.first, cell.second - cell.first ) );
         }
+    }
+    return names;
+}
 
-    } catch( ifstream::failure e ) {
-        string errorStr = "I/O exception while processing "+fileName+" error: "+strerror(errno);
-        H_THROW( errorStr );
-    } catch( bad_lexical_cast& castException ) {
-        H_THROW( "Could not convert index to double on line: "+lexical_cast<string>( lineNum )+", exception: "
-                +castException.what() );
+//------------------------------------------------------------------------------
+/*! \brief The names of the data columns, i.e. all but the first
+ *
+ *  \exception h_exception For any I/O errors or improper formatting.
+ */
+vector<string> CSVTableReader::getColumnNames() {
+    shared_ptr<const csv_table> table = getTable();
+    return vector<string>( table->colnames.begin() + 1, table->colnames.end() );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief The values of varName in each data row, for a table whose rows are
+ *         named rather than dated
+ *
+ *  The values line up with getRowNames.  Each has the units given by the most
+ *  recent UNITS row (if any); blank cells are MISSING_FLOAT.
+ *
+ *  \param varName The variable name to look for in the CSV file.
+ *  \exception h_exception For any I/O errors, improper formatting, and
+ *                         inability to find varName.
+ */
+vector<unitval> CSVTableReader::getValues( const string& varName ) {
+    shared_ptr<const csv_table> table = getTable();
+    shared_ptr<const csv_table::column> column =
+        table->getColumn( findColumn( *table, varName ), fileName );
+    vector<unitval> values;
+    const string* unitsLabel = 0;
+    unit_types units = U_UNDEFINED;
+    for( size_t i = 0; i < column->values.size(); ++i ) {
+        if( table->units_row[ i ] ) {
+            continue;
+        }
+        if( !unitsLabel || *unitsLabel != column->units[ i ] ) {
+            unitsLabel = &column->units[ i ];
+            units = unitsLabel->empty() ? U_UNDEFINED : unitval::parseUnitsName( *unitsLabel );
+        }
+        values.push_back( unitval( column->blank[ i ] ? MISSING_FLOAT : column->values[ i ], units ) );
     }
-    // h_exceptions from setData should just be passed along
+    return values;
 }
 
 }
@@ -12,18 +12,16 @@
  *
  */
 
-// some boost headers generate warnings under clang; not our problem, ignore
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Weverything"
-#include <boost/array.hpp>
-#pragma clang diagnostic pop
+#include <algorithm>
+#include <cmath>
+#include <sstream>
 
 #include "forcing_component.hpp"
 #include "avisitor.hpp"
 
 namespace Hector {
 
-/* These next two arrays and the map that connects them are a
+/* The adjusted halocarbon forcing names and the way they map to agents are a
  * workaround for the problems created by storing the halocarbon
  * forcings in the halocarbon components.  Because the halocarbon
  * components don't know about the base year adjustments, they can't
@@ -36,9 +34,8 @@ namespace Hector {
  * The solution we adopted was to create a second set of capabilities
  * to refer to the adjusted values, and we let the forcing component
  * intercept those.  However, the forcing values themselves are stored
- * under the names used for the unadjusted values, so we have to have
- * a name translation table so that we can find the data that the
- * message is asking for.  In the end, the whole process winds up
+ * under the agents used for the unadjusted values, so both names
+ * have to map to the same agent (see agent_index).  In the end, the whole process winds up
  * being a little ugly, but it gets the job done.
  */
 
@@ -71,7 +68,7 @@ const char *ForcingComponent::adjusted_halo_forcings[N_HALO_FORCINGS] = {
     D_RFADJ_CH3Br
 };
 
-const char *ForcingComponent::halo_forcing_names[N_HALO_FORCINGS] = {
+const char *ForcingComponent::forcing_names[N_FORCING_AGENTS] = {
     D_RF_CF4,
     D_RF_C2F6,
     D_RF_HFC23,
@@ -97,10 +94,51 @@ const char *ForcingComponent::halo_forcing_names[N_HALO_FORCINGS] = {
     D_RF_halon1301,
     D_RF_halon2402,
     D_RF_CH3Cl,
-    D_RF_CH3Br
+    D_RF_CH3Br,
+    D_RF_CO2,
+    D_RF_CH4,
+    D_RF_N2O,
+    D_RF_H2O_STRAT,
+    D_RF_O3_TROP,
+    D_RF_BC,
+    D_RF_OC,
+    D_RF_SO2d,
+    D_RF_SO2i,
+    D_RF_VOL,
+    D_RF_T_ALBEDO,
+    D_RF_TOTAL
 };
 
-std::map<std::string, std::string> ForcingComponent::forcing_name_map;
+//------------------------------------------------------------------------------
+/*! \brief Map variable names to forcing agents
+ *
+ *  Both the raw and the base year adjusted halocarbon forcing names map to
+ *  the halocarbon's agent.
+ */
+const std::map<std::string, int>& ForcingComponent::agent_index() {
+    static const std::map<std::string, int> index = [] {
+        std::map<std::string, int> m;
+        for( int i = 0; i < N_FORCING_AGENTS; ++i ) {
+            m[ forcing_names[ i ] ] = i;
+        }
+        for( int i = 0; i < N_HALO_FORCINGS; ++i ) {
+            m[ adjusted_halo_forcings[ i ] ] = FA_HALO + i;
+        }
+        return m;
+    }();
+    return index;
+}
+
+const char *ForcingComponent::exogenous_inputs[] = {
+    D_EMISSIONS_BC,
+    D_EMISSIONS_OC,
+    D_EMISSIONS_SO2,
+    D_2000_SO2,
+    D_NATURAL_SO2,
+    D_VOLCANIC_SO2,
+    D_RF_T_ALBEDO,
+    NULL
+};
 
 using namespace std;
 
@@ -134,6 +172,8 @@ void ForcingComponent::init( Core* coreptr ) {
 
     baseyear = 0.0;
     currentYear = 0.0;
+    exogenous_version = 0;
+    exogenous_stale = true;
 
     Ftot_constrain.allowInterp( true );
     Ftot_constrain.name = D_RF_TOTAL;
@@ -154,7 +194,6 @@ void ForcingComponent::init( Core* coreptr ) {
     core->registerCapability( D_RF_VOL, getComponentName());
     for(int i=0; i<N_HALO_FORCINGS; ++i) {
         core->registerCapability(adjusted_halo_forcings[i], getComponentName());
-        forcing_name_map[adjusted_halo_forcings[i]] = halo_forcing_names[i];
     }
 
     // Register our dependencies
@@ -260,7 +299,8 @@ void ForcingComponent::prepareToRun() {
         H_LOG( glog, Logger::WARNING ) << "Total forcing will be overwritten by user-supplied values!" << std::endl;
     }
 
-    baseyear_forcings.clear();
+    std::fill( baseyear_forcings, baseyear_forcings + N_FORCING_AGENTS, 0.0 );
+    exogenous_stale = true;
 }
 
 //------------------------------------------------------------------------------
@@ -276,7 +316,10 @@ void ForcingComponent::run( const double runToDate ) {
     if( runToDate < baseyear ) {
         H_LOG( logger, Logger::DEBUG ) << "not yet at baseyear" << std::endl;
     } else {
-        forcings_t forcings;
+        double forcings[ N_FORCING_AGENTS ];
+        std::bitset<N_FORCING_AGENTS> present;
+        present.set( FA_CO2 );
+        present.set( FA_TOTAL );
 
         // ---------- CO2 ----------
         // Instantaneous radiative forcings for CO2, CH4, and N2O from http://www.esrl.noaa.gov/gmd/aggi/
@@ -286,12 +329,7 @@ void ForcingComponent::run( const double runToDate ) {
         unitval Ca = core->sendMessage( M_GETDATA, D_ATMOSPHERIC_CO2 );
         if( runToDate==baseyear )
             C0 = Ca;
-        forcings[D_RF_CO2 ].set( 5.35 * log( Ca/C0 ), U_W_M2 );
-
-        // ---------- Terrestrial albedo ----------
-        if( core->checkCapability( D_RF_T_ALBEDO ) ) {
-            forcings[ D_RF_T_ALBEDO ] = core->sendMessage( M_GETDATA, D_RF_T_ALBEDO, message_data( runToDate ) );
-        }
+        forcings[ FA_CO2 ] = 5.35 * log( Ca/C0 );
 
         // ---------- N2O and CH4 ----------
         // Equations from Joos et al., 2001
@@ -304,15 +342,18 @@ void ForcingComponent::run( const double runToDate ) {
             double N0 = core->sendMessage( M_GETDATA, D_PREINDUSTRIAL_N2O ).value( U_PPBV_N2O );
 
             double fch4 =  0.036 * ( sqrt( Ma ) - sqrt( M0 ) ) - ( f( Ma, N0 ) - f( M0, N0 ) );
-            forcings[D_RF_CH4].set( fch4, U_W_M2 );
+            forcings[ FA_CH4 ] = fch4;
 
             double fn2o =  0.12 * ( sqrt( Na ) - sqrt( N0 ) ) - ( f( M0, Na ) - f( M0, N0 ) );
-            forcings[D_RF_N2O].set( fn2o, U_W_M2 );
+            forcings[ FA_N2O ] = fn2o;
 
             // ---------- Stratospheric H2O from CH4 oxidation ----------
             // From Tanaka et al, 2007, but using Joos et al., 2001 value of 0.05
             const double fh2o = 0.05 * ( 0.036 * ( sqrt( Ma ) - sqrt( M0 ) ) );
-            forcings[D_RF_H2O_STRAT].set( fh2o, U_W_M2 );
+            forcings[ FA_H2O_STRAT ] = fh2o;
+            present.set( FA_CH4 );
+            present.set( FA_N2O );
+            present.set( FA_H2O_STRAT );
         }
 
         // ---------- Troposheric Ozone ----------
@@ -320,106 +361,56 @@ void ForcingComponent::run( const double runToDate ) {
             //from Tanaka et al, 2007
             const double ozone = core->sendMessage( M_GETDATA, D_ATMOSPHERIC_O3, message_data( runToDate ) ).value( U_DU_O3 );
             const double fo3 = 0.042 * ozone;
-            forcings[D_RF_O3_TROP].set( fo3, U_W_M2 );
+            forcings[ FA_O3_TROP ] = fo3;
+            present.set( FA_O3_TROP );
         }
 
         // ---------- Halocarbons ----------
         // TODO: Would like to just 'know' all the halocarbon instances out there
-        boost::array<string, 26> halos = {
-            {
-                D_RF_CF4,
-                D_RF_C2F6,
-                D_RF_HFC23,
-                D_RF_HFC32,
-                D_RF_HFC4310,
-                D_RF_HFC125,
-                D_RF_HFC134a,
-                D_RF_HFC143a,
-                D_RF_HFC227ea,
-                D_RF_HFC245fa,
-                D_RF_SF6,
-                D_RF_CFC11,
-                D_RF_CFC12,
-                D_RF_CFC113,
-                D_RF_CFC114,
-                D_RF_CFC115,
-                D_RF_CCl4,
-                D_RF_CH3CCl3,
-                D_RF_HCFC22,
-                D_RF_HCFC141b,
-                D_RF_HCFC142b,
-                D_RF_halon1211,
-                D_RF_halon1301,
-                D_RF_halon2402,
-                D_RF_CH3Cl,
-                D_RF_CH3Br
-            }
-        };
-
         // Halocarbons can be disabled individually via the input file, so we run through all possible ones
-         for (unsigned hc=0; hc<halos.size(); ++hc) {
-            if( core->checkCapability( halos[hc] ) ) {
+        for( int hc = 0; hc < N_HALO_FORCINGS; ++hc ) {
+            const char *halo = forcing_names[ FA_HALO + hc ];
+            if( core->checkCapability( halo ) ) {
                 // Forcing values are actually computed by the halocarbon itself
-                forcings[ halos[hc] ] = core->sendMessage( M_GETDATA, halos[hc], message_data( runToDate ) );
-                }
-        }
-
-        // ---------- Black carbon ----------
-        if( core->checkCapability( D_EMISSIONS_BC ) ) {
-            double fbc = 0.0743 * core->sendMessage( M_GETDATA, D_EMISSIONS_BC, message_data( runToDate ) ).value( U_TG );
-            forcings[D_RF_BC].set( fbc, U_W_M2 );
-            // includes both indirect and direct forcings from Bond et al 2013, Journal of Geophysical Research Atmo (table C1 - Central)
-        }
-
-        // ---------- Organic carbon ----------
-        if( core->checkCapability( D_EMISSIONS_OC ) ) {
-            double foc = -0.0128 * core->sendMessage( M_GETDATA, D_EMISSIONS_OC, message_data( runToDate ) ).value( U_TG );
-            forcings[D_RF_OC].set( foc, U_W_M2 );
-            // includes both indirect and direct forcings from Bond et al 2013, Journal of Geophysical Research Atmo (table C1 - Central).
-            // The fossil fuel and biomass are weighted (-4.5) then added to the snow and clouds for a total of -12.8 (personal communication Steve Smith, PNNL)
+                forcings[ FA_HALO + hc ] = core->sendMessage( M_GETDATA, halo, message_data( runToDate ) ).value( U_W_M2 );
+                present.set( FA_HALO + hc );
+            }
         }
 
-        // ---------- Sulphate Aerosols ----------
-        if( core->checkCapability( D_NATURAL_SO2 ) && core->checkCapability( D_EMISSIONS_SO2 ) ) {
-
-            unitval S0 = core->sendMessage( M_GETDATA, D_2000_SO2 );
-            unitval SN = core->sendMessage( M_GETDATA, D_NATURAL_SO2 );
-
-            // Includes only direct forcings from Forster et al 2007 (IPCC)
-            // Equations from Joos et al., 2001
-            H_ASSERT( S0.value( U_GG_S ) >0, "S0 is 0" );
-            unitval emission = core->sendMessage( M_GETDATA, D_EMISSIONS_SO2, message_data( runToDate ) );
-            double fso2d = -0.35 * emission/S0;
-            forcings[D_RF_SO2d].set( fso2d, U_W_M2 );
-            // includes only direct forcings from Forster etal 2007 (IPCC)
-
-            // Indirect aerosol effect via changes in cloud properties
-            const double a = -0.6 * ( log( ( SN.value( U_GG_S ) + emission.value( U_GG_S ) ) / SN.value( U_GG_S ) ) ); // -.6
-            const double b =  pow ( log ( ( SN.value( U_GG_S ) + S0.value( U_GG_S ) ) / SN.value( U_GG_S ) ), -1 );
-            double fso2i = a * b;
-            forcings[D_RF_SO2i].set( fso2i, U_W_M2 );
+        // ---------- Exogenous forcings: black and organic carbon, SO2, volcanic, albedo ----------
+        if( exogenous_stale ) {
+            precompute_exogenous();
         }
-
-        if( core->checkCapability( D_VOLCANIC_SO2 ) ) {
-            // Volcanic forcings
-            forcings[D_RF_VOL] = core->sendMessage( M_GETDATA, D_VOLCANIC_SO2, message_data( runToDate ) );
+        const size_t row = size_t( ::round( runToDate - baseyear ) );
+        if( exogenous_current() && ( row + 1 ) * N_FORCING_AGENTS <= exogenous_ts.size() ) {
+            const double *exogenous = &exogenous_ts[ row * N_FORCING_AGENTS ];
+            for( int i = 0; i < N_FORCING_AGENTS; ++i ) {
+                if( exogenous_present[ i ] ) {
+                    forcings[ i ] = exogenous[ i ];
+                }
+            }
+            present |= exogenous_present;
+        } else {
+            exogenous_forcings( runToDate, forcings, present );
         }
 
         // ---------- Total ----------
-        unitval Ftot( 0.0, U_W_M2 );  // W/m2
-        for( forcingsIterator it = forcings.begin(); it != forcings.end(); ++it ) {
-            Ftot = Ftot + ( *it ).second;
-            H_LOG( logger, Logger::DEBUG ) << "forcing " << ( *it).first << " in " << runToDate << " is " << ( *it ).second << std::endl;
+        double Ftot = 0.0;  // W/m2
+        for( int i = 0; i < FA_TOTAL; ++i ) {
+            if( present[ i ] ) {
+                Ftot += forcings[ i ];
+                H_LOG( logger, Logger::DEBUG ) << "forcing " << forcing_names[ i ] << " in " << runToDate << " is " << forcings[ i ] << std::endl;
+            }
         }
 
         // If the user has supplied total forcing data, use that
         if( Ftot_constrain.size() && runToDate <= Ftot_constrain.lastdate() ) {
             H_LOG( logger, Logger::WARNING ) << "** Overwriting total forcing with user-supplied value" << std::endl;
-            forcings[ D_RF_TOTAL ] = Ftot_constrain.get( runToDate );
+            forcings[ FA_TOTAL ] = Ftot_constrain.get( runToDate ).value( U_W_M2 );
         } else {
-            forcings[ D_RF_TOTAL ] = Ftot;
+            forcings[ FA_TOTAL ] = Ftot;
         }
-        H_LOG( logger, Logger::DEBUG ) << "forcing total is " << forcings[ D_RF_TOTAL ] << std::endl;
+        H_LOG( logger, Logger::DEBUG ) << "forcing total is " << forcings[ FA_TOTAL ] << std::endl;
 
         //---------- Change to relative forcing ----------
         // Note that the code below assumes model is always consistently run from base-year forward.
@@ -428,17 +419,140 @@ void ForcingComponent::run( const double runToDate ) {
        // At this point, we've computed all absolute forcings. If base year, save those values
         if( runToDate==baseyear ) {
             H_LOG( logger, Logger::DEBUG ) << "** At base year! Storing current forcing values" << std::endl;
-            baseyear_forcings = forcings;
+            for( int i = 0; i < N_FORCING_AGENTS; ++i ) {
+                baseyear_forcings[ i ] = present[ i ] ? forcings[ i ] : 0.0;
+            }
         }
+        agent_present = present;
+
+        // Store the forcings that we have calculated, relative to the base year
+        H_ASSERT( row * N_FORCING_AGENTS <= forcings_ts.size(), "forcing years must be run in order" );
+        forcings_ts.resize( ( row + 1 ) * N_FORCING_AGENTS );
+        double *stored = &forcings_ts[ row * N_FORCING_AGENTS ];
+        for( int i = 0; i < N_FORCING_AGENTS; ++i ) {
+            stored[ i ] = present[ i ] ? forcings[ i ] - baseyear_forcings[ i ] : 0.0;
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Calculate the forcings that depend only on input time series
+ *  \param date      date to calculate for
+ *  \param forcings  forcing of each agent, W/m2 (only the exogenous agents are set)
+ *  \param present   the exogenous agents that are calculated are marked here
+ */
+void ForcingComponent::exogenous_forcings( const double date, double forcings[],
+                                           std::bitset<N_FORCING_AGENTS>& present )
+{
+    // ---------- Terrestrial albedo ----------
+    if( core->checkCapability( D_RF_T_ALBEDO ) ) {
+        forcings[ FA_T_ALBEDO ] = core->sendMessage( M_GETDATA, D_RF_T_ALBEDO, message_data( date ) ).value( U_W_M2 );
+        present.set( FA_T_ALBEDO );
+    }
+
+    // ---------- Black carbon ----------
+    if( core->checkCapability( D_EMISSIONS_BC ) ) {
+        double fbc = 0.0743 * core->sendMessage( M_GETDATA, D_EMISSIONS_BC, message_data( date ) ).value( U_TG );
+        forcings[ FA_BC ] = fbc;
+        present.set( FA_BC );
+        // includes both indirect and direct forcings from Bond et al 2013, Journal of Geophysical Research Atmo (table C1 - Central)
+    }
+
+    // ---------- Organic carbon ----------
+    if( core->checkCapability( D_EMISSIONS_OC ) ) {
+        double foc = -0.0128 * core->sendMessage( M_GETDATA, D_EMISSIONS_OC, message_data( date ) ).value( U_TG );
+        forcings[ FA_OC ] = foc;
+        present.set( FA_OC );
+        // includes both indirect and direct forcings from Bond et al 2013, Journal of Geophysical Research Atmo (table C1 - Central).
+        // The fossil fuel and biomass are weighted (-4.5) then added to the snow and clouds for a total of -12.8 (personal communication Steve Smith, PNNL)
+    }
+
+    // ---------- Sulphate Aerosols ----------
+    if( core->checkCapability( D_NATURAL_SO2 ) && core->checkCapability( D_EMISSIONS_SO2 ) ) {
 
-        // Subtract base year forcing values from forcings, i.e. make them relative to base year
-        for( forcingsIterator it = forcings.begin(); it != forcings.end(); ++it ) {
-            forcings[ ( *it ).first ] = ( *it ).second - baseyear_forcings[ ( *it ).first ];
+        unitval S0 = core->sendMessage( M_GETDATA, D_2000_SO2 );
+        unitval SN = core->sendMessage( M_GETDATA, D_NATURAL_SO2 );
+
+        // Includes only direct forcings from Forster et al 2007 (IPCC)
+        // Equations from Joos et al., 2001
+        H_ASSERT( S0.value( U_GG_S ) >0, "S0 is 0" );
+        unitval emission = core->sendMessage( M_GETDATA, D_EMISSIONS_SO2, message_data( date ) );
+        double fso2d = -0.35 * emission/S0;
+        forcings[ FA_SO2D ] = fso2d;
+        present.set( FA_SO2D );
+        // includes only direct forcings from Forster etal 2007 (IPCC)
+
+        // Indirect aerosol effect via changes in cloud properties
+        const double a = -0.6 * ( log( ( SN.value( U_GG_S ) + emission.value( U_GG_S ) ) / SN.value( U_GG_S ) ) ); // -.6
+        const double b =  pow ( log ( ( SN.value( U_GG_S ) + S0.value( U_GG_S ) ) / SN.value( U_GG_S ) ), -1 );
+        double fso2i = a * b;
+        forcings[ FA_SO2I ] = fso2i;
+        present.set( FA_SO2I );
+    }
+
+    if( core->checkCapability( D_VOLCANIC_SO2 ) ) {
+        // Volcanic forcings
+        forcings[ FA_VOL ] = core->sendMessage( M_GETDATA, D_VOLCANIC_SO2, message_data( date ) ).value( U_W_M2 );
+        present.set( FA_VOL );
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Evaluate the exogenous forcings for every year of the run
+ *
+ *  Rows run from the base year to the end date, or up to the first year for
+ *  which the inputs can't be evaluated; later years are calculated as they
+ *  are run, which reports any error at the point it matters.
+ */
+void ForcingComponent::precompute_exogenous()
+{
+    exogenous_stale = false;
+    exogenous_version = core->getInputVersion();
+    exogenous_ts.clear();
+    exogenous_present.reset();
+
+    const int nyear = int( core->getEndDate() - baseyear ) + 1;
+    if( nyear <= 0 ) return;
+    exogenous_ts.reserve( size_t( nyear ) * N_FORCING_AGENTS );
+
+    std::bitset<N_FORCING_AGENTS> present;
+    double forcings[ N_FORCING_AGENTS ];
+    for( int i = 0; i < nyear; ++i ) {
+        present.reset();
+        try {
+            exogenous_forcings( baseyear + i, forcings, present );
+        } catch( h_exception& e ) {
+            break;
         }
+        exogenous_ts.insert( exogenous_ts.end(), forcings, forcings + N_FORCING_AGENTS );
+        exogenous_present = present;
+    }
+    H_LOG( logger, Logger::DEBUG ) << "Precomputed exogenous forcings for "
+        << exogenous_ts.size() / N_FORCING_AGENTS << " years" << std::endl;
+}
 
-        // Store the forcings that we have calculated
-        forcings_ts.set(runToDate, forcings);
+//------------------------------------------------------------------------------
+/*! \brief Check that no input of the exogenous forcings has changed
+ *
+ *  If one has, the precomputed values are dropped; they are recomputed at
+ *  the next reset (or prepareToRun), since inputs set while the model is
+ *  running (e.g. emissions supplied one year at a time by a coupled model)
+ *  would otherwise force a recomputation every year.
+ */
+bool ForcingComponent::exogenous_current()
+{
+    if( core->getInputVersion() == exogenous_version ) {
+        return true;
+    }
+    for( int i = 0; exogenous_inputs[ i ]; ++i ) {
+        if( core->getInputVersion( exogenous_inputs[ i ] ) > exogenous_version ) {
+            exogenous_ts.clear();
+            return false;
+        }
     }
+    // Only unrelated inputs have been set
+    exogenous_version = core->getInputVersion();
+    return true;
 }
 
 //------------------------------------------------------------------------------
@@ -467,40 +581,16 @@ unitval ForcingComponent::getData( const std::string& varName,
                                  << baseyear
                                  << std::endl;
 
-    forcings_t forcings(forcings_ts.get(getdate));
-
     if( varName == D_RF_BASEYEAR ) {
         returnval.set( baseyear, U_UNITLESS );
     } else if (varName == D_RF_SO2) {
-        // total SO2 forcing
-        std::map<std::string, unitval>::const_iterator forcing_SO2d = forcings.find( D_RF_SO2d );
-        std::map<std::string, unitval>::const_iterator forcing_SO2i = forcings.find( D_RF_SO2i );
-        if ( forcing_SO2d != forcings.end() ) {
-            if ( forcing_SO2i != forcings.end() ) {
-                returnval = forcing_SO2d->second + forcing_SO2i->second;
-            } else {
-                returnval = forcing_SO2d->second;
-            }
-        } else {
-            if ( forcing_SO2i != forcings.end() ) {
-                returnval = forcing_SO2i->second;
-            } else {
-                returnval.set( 0.0, U_W_M2 );
-            }
-        }
+        // total SO2 forcing (zero if neither part is computed)
+        const double *forcings = forcings_at( getdate );
+        returnval.set( forcings[ FA_SO2D ] + forcings[ FA_SO2I ], U_W_M2 );
     } else {
-        std::string forcing_name;
-        auto forcit = forcing_name_map.find(varName);
-        if(forcit != forcing_name_map.end()) {
-            forcing_name = forcing_name_map[varName];
-        }
-        else {
-            forcing_name = varName;
-        }
-        std::map<std::string, unitval>::const_iterator forcing = forcings.find(forcing_name);
-        if ( forcing != forcings.end() ) {
-            // from the forcing map
-            returnval = forcing->second;
+        std::map<std::string, int>::const_iterator agent = agent_index().find( varName );
+        if( agent != agent_index().end() && agent_present[ agent->second ] ) {
+            returnval.set( forcings_at( getdate )[ agent->second ], U_W_M2 );
         } else {
             if (currentYear < baseyear) {
                 returnval.set( 0.0, U_W_M2 );
@@ -513,11 +603,34 @@ unitval ForcingComponent::getData( const std::string& varName,
     return returnval;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Look up the forcings recorded for a date
+ *  \param date  date to look up; must be between baseyear and the last date run
+ *  \returns pointer to the forcing of each agent (indexed by forcing_agent)
+ */
+const double* ForcingComponent::forcings_at( const double date ) const {
+    const double row = ::round( date - baseyear );
+    if( row < 0 || ( row + 1 ) * N_FORCING_AGENTS > forcings_ts.size() ) {
+        std::ostringstream errmsg;
+        errmsg << "No data at requested time= " << date << "\n";
+        H_THROW( errmsg.str() );
+    }
+    return &forcings_ts[ size_t( row ) * N_FORCING_AGENTS ];
+}
+
 void ForcingComponent::reset(double time)
 {
     // Set the current year to the reset year, and drop outputs after the reset year.
     currentYear = time;
-    forcings_ts.truncate(time);
+    const double nkeep = std::floor( time - baseyear ) + 1;
+    if( nkeep < 0 ) {
+        forcings_ts.clear();
+    } else if( nkeep * N_FORCING_AGENTS < forcings_ts.size() ) {
+        forcings_ts.resize( size_t( nkeep ) * N_FORCING_AGENTS );
+    }
+    if( !exogenous_current() ) {
+        exogenous_stale = true;
+    }
     H_LOG(logger, Logger::NOTICE)
         << getComponentName() << " reset to time= " << time << "\n";
 }
@@ -0,0 +1,66 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  gridded_output_visitor.cpp
+ *  hector
+ *
+ */
+
+#include <cstdint>
+
+#include "gridded_output_visitor.hpp"
+#include "temperature_component.hpp"
+#include "h_exception.hpp"
+
+namespace Hector {
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+/*! \brief Constructor
+ *  \param fileName The file to write the gridded output to.
+ */
+GriddedOutputVisitor::GriddedOutputVisitor( const string& fileName )
+:fileName( fileName ), current_date( 0 )
+{
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Destructor
+ */
+GriddedOutputVisitor::~GriddedOutputVisitor() {
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+bool GriddedOutputVisitor::shouldVisit( const bool in_spinup, const double date ) {
+    current_date = date;
+    return !in_spinup;
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+void GriddedOutputVisitor::visit( TemperatureComponent* c ) {
+    const size_t ncell = c->npatterncell();
+    if( ncell == 0 ) return;
+
+    if( !gridFile.is_open() ) {
+        gridFile.open( fileName.c_str(), ios::out | ios::binary );
+        H_ASSERT( gridFile.is_open(), "Could not open gridded output file: " + fileName );
+        const int32_t n = ncell;
+        gridFile.write( "HGRD", 4 );
+        gridFile.write( reinterpret_cast<const char*>( &n ), sizeof n );
+        gridFile.write( reinterpret_cast<const char*>( c->pattern_latitude().data() ), ncell * sizeof( float ) );
+        gridFile.write( reinterpret_cast<const char*>( c->pattern_longitude().data() ), ncell * sizeof( float ) );
+    }
+
+    gridFile.write( reinterpret_cast<const char*>( &current_date ), sizeof current_date );
+    gridFile.write( reinterpret_cast<const char*>( c->gridded_temperature().data() ), ncell * sizeof( float ) );
+    H_ASSERT( gridFile, "Could not write gridded output file: " + fileName );
+}
+
+}
@@ -13,23 +13,59 @@
  */
 
 #include <math.h>
+#include <limits>
 
 #include "halocarbon_component.hpp"
 #include "core.hpp"
 #include "h_util.hpp"
 #include "avisitor.hpp"
+#include "simpleNbox.hpp"
 
 namespace Hector {
 
 using namespace std;
 
+//------------------------------------------------------------------------------
+/*! \brief Names of the halocarbons, in the order they are stored
+ *
+ *  This is the order the forcing component lists them in, which was also
+ *  the order of the per-gas components, so output rows keep their order.
+ */
+const char *HalocarbonComponent::gas_names[] = {
+    CF4_COMPONENT_BASE, C2F6_COMPONENT_BASE, HFC23_COMPONENT_BASE,
+    HFC32_COMPONENT_BASE, HFC4310_COMPONENT_BASE, HFC125_COMPONENT_BASE,
+    HFC134a_COMPONENT_BASE, HFC143a_COMPONENT_BASE, HFC227ea_COMPONENT_BASE,
+    HFC245fa_COMPONENT_BASE, SF6_COMPONENT_BASE, CFC11_COMPONENT_BASE,
+    CFC12_COMPONENT_BASE, CFC113_COMPONENT_BASE, CFC114_COMPONENT_BASE,
+    CFC115_COMPONENT_BASE, CCl4_COMPONENT_BASE, CH3CCl3_COMPONENT_BASE,
+    HCFC22_COMPONENT_BASE, HCFC141b_COMPONENT_BASE, HCFC142b_COMPONENT_BASE,
+    halon1211_COMPONENT_BASE, halon1301_COMPONENT_BASE, halon2402_COMPONENT_BASE,
+    CH3Br_COMPONENT_BASE, CH3Cl_COMPONENT_BASE
+};
+
 //------------------------------------------------------------------------------
 /*! \brief Constructor
  */
-HalocarbonComponent::HalocarbonComponent( std::string g )
-:tau( -1 )
+HalocarbonComponent::HalocarbonComponent()
+:ngas( sizeof( gas_names ) / sizeof( gas_names[0] ) ),
+ enabled( ngas, true ), tau( ngas, -1 ),
+ rho( ngas, numeric_limits<double>::quiet_NaN() ),
+ molarMass( ngas, 0.0 ),
+ H0( ngas, 0.0 ),       //! Default is no preindustrial, but user can override
+ decay( ngas ), emissions( ngas ), Ha_constrain( ngas ),
+ emiss( ngas ), constrained( ngas )
 {
-    myGasName = g;
+    for( int i = 0; i < ngas; ++i ) {
+        const string gas( gas_names[ i ] );
+        gas_component.push_back( gas + HALOCARBON_EXTENSION );
+        gas_aliases[ gas_component[ i ] ] = i;
+        gas_vars[ D_RF_PREFIX + gas ] = make_pair( i, HC_FORCING );
+        gas_vars[ gas + CONCENTRATION_EXTENSION ] = make_pair( i, HC_CONCENTRATION );
+        gas_vars[ gas + CONC_CONSTRAINT_EXTENSION ] = make_pair( i, HC_CONSTRAIN );
+        gas_vars[ gas + EMISSIONS_EXTENSION ] = make_pair( i, HC_EMISSIONS );
+        emissions[ i ].allowInterp( true );
+        emissions[ i ].name = gas;
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -41,32 +77,33 @@ HalocarbonComponent::~HalocarbonComponent() {
 //------------------------------------------------------------------------------
 // documentation is inherited
 string HalocarbonComponent::getComponentName() const {
-    return myGasName + HALOCARBON_EXTENSION;
+    return string( HALOCARBON_COMPONENT_NAME );
 }
 
 //------------------------------------------------------------------------------
 // documentation is inherited
 void HalocarbonComponent::init( Core* coreptr ) {
     logger.open( getComponentName(), false, coreptr->getGlobalLogger().getEchoToFile(), coreptr->getGlobalLogger().getMinLogLevel() );
-    //    concentration.name = myGasName;
     core = coreptr;
 
-    emissions.allowInterp( true );
-    emissions.name = myGasName;
-    molarMass = 0.0;
-    H0.set( 0.0, U_PPTV );      //! Default is no preindustrial, but user can override
-
-    //! \remark Inform core that we can provide forcing data
-    core->registerCapability( D_RF_PREFIX+myGasName, getComponentName() );
-    //! \remark Inform core that we can provide concentrations
-    core->registerCapability( myGasName+CONCENTRATION_EXTENSION, getComponentName() );
-    //! \remark Inform core that we can provide concentration constraints
-    core->registerCapability( myGasName+CONC_CONSTRAINT_EXTENSION, getComponentName() );
-    // inform core that we can accept emissions for this gas
-    core->registerInput(myGasName+EMISSIONS_EXTENSION, getComponentName());
-
-    // inform core that we can accept concentration constraints for this gas
-    core->registerInput(myGasName+CONC_CONSTRAINT_EXTENSION, getComponentName()); 
+    for( int i = 0; i < ngas; ++i ) {
+        const string gas( gas_names[ i ] );
+        const string& name = gas_component[ i ];
+
+        //! \remark Each gas is addressed by its own component name
+        core->registerComponentAlias( name, getComponentName() );
+        //! \remark Inform core that we can provide forcing data
+        core->registerCapability( D_RF_PREFIX+gas, name );
+        //! \remark Inform core that we can provide concentrations
+        core->registerCapability( gas+CONCENTRATION_EXTENSION, name );
+        //! \remark Inform core that we can provide concentration constraints
+        core->registerCapability( gas+CONC_CONSTRAINT_EXTENSION, name );
+        // inform core that we can accept emissions for this gas
+        core->registerInput( gas+EMISSIONS_EXTENSION, name );
+
+        // inform core that we can accept concentration constraints for this gas
+        core->registerInput( gas+CONC_CONSTRAINT_EXTENSION, name );
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -92,6 +129,34 @@ unitval HalocarbonComponent::sendMessage( const std::string& message,
     return returnval;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Find the gas a variable name refers to
+ *  \param varName Variable name, either per-gas (e.g. `CF4_emissions`) or
+ *                 prefixed with the gas's component name (e.g.
+ *                 `CF4_halocarbon.tau`).
+ *  \param var     Set to the variable name without any prefix.
+ *  \returns Index of the gas, or -1 if the name doesn't identify one.
+ */
+int HalocarbonComponent::parse_gas( const string& varName, string& var ) const {
+    int gas = -1;
+    const size_t sep = varName.find( SNBOX_PARSECHAR );
+    if( sep == string::npos ) {
+        var = varName;
+    } else {
+        const map<string, int>::const_iterator it = gas_aliases.find( varName.substr( 0, sep ) );
+        H_ASSERT( it != gas_aliases.end(), "Unknown halocarbon: " + varName.substr( 0, sep ) );
+        gas = it->second;
+        var = varName.substr( sep + 1 );
+    }
+
+    const map<string, pair<int, gas_var> >::const_iterator it = gas_vars.find( var );
+    if( it != gas_vars.end() ) {
+        H_ASSERT( gas < 0 || gas == it->second.first, "Variable " + var + " does not belong to " + varName.substr( 0, sep ) );
+        gas = it->second.first;
+    }
+    return gas;
+}
+
 //------------------------------------------------------------------------------
 // documentation is inherited
 void HalocarbonComponent::setData( const string& varName,
@@ -100,31 +165,33 @@ void HalocarbonComponent::setData( const string& varName,
     H_LOG( logger, Logger::DEBUG ) << "Setting " << varName << "[" << data.date << "]=" << data.value_str << std::endl;
 
     try {
-        const string emiss_var_name = myGasName + EMISSIONS_EXTENSION;
-        const string conc_var_name = myGasName + CONC_CONSTRAINT_EXTENSION;
+        string var;
+        const int i = parse_gas( varName, var );
+        H_ASSERT( i >= 0, "Halocarbon not specified" );
 
-        if( varName == D_HC_TAU ) {
+        const map<string, pair<int, gas_var> >::const_iterator gv = gas_vars.find( var );
+        if( var == D_HC_TAU ) {
             H_ASSERT( data.date == Core::undefinedIndex() , "date not allowed" );
-            tau = data.getUnitval(U_UNDEFINED);
-        } else if( varName == D_HC_RHO ) {
+            tau[ i ] = data.getUnitval(U_UNDEFINED);
+        } else if( var == D_HC_RHO ) {
             H_ASSERT( data.date == Core::undefinedIndex() , "date not allowed" );
-            rho = data.getUnitval(U_W_M2_PPTV);
-        } else if( varName == D_HC_MOLARMASS ) {
+            rho[ i ] = data.getUnitval(U_W_M2_PPTV).value( U_W_M2_PPTV );
+        } else if( var == D_HC_MOLARMASS ) {
             H_ASSERT( data.date == Core::undefinedIndex() , "date not allowed" );
-            molarMass = data.getUnitval(U_UNDEFINED);
-        } else if( varName == emiss_var_name ) {
+            molarMass[ i ] = data.getUnitval(U_UNDEFINED);
+        } else if( gv != gas_vars.end() && gv->second.second == HC_EMISSIONS ) {
             H_ASSERT( data.date != Core::undefinedIndex(), "date required" );
-            emissions.set(data.date, data.getUnitval(U_GG));
-        } else if( varName == conc_var_name ) {
+            emissions[ i ].set(data.date, data.getUnitval(U_GG));
+        } else if( gv != gas_vars.end() && gv->second.second == HC_CONSTRAIN ) {
             H_ASSERT( data.date != Core::undefinedIndex(), "date required" );
-            Ha_constrain.set(data.date, data.getUnitval(U_PPTV));
-        } else if( varName == D_PREINDUSTRIAL_HC ) {
+            Ha_constrain[ i ].set(data.date, data.getUnitval(U_PPTV));
+        } else if( var == D_PREINDUSTRIAL_HC ) {
             H_ASSERT( data.date == Core::undefinedIndex() , "date not allowed" );
-            H0 = data.getUnitval(U_PPTV);
+            H0[ i ] = data.getUnitval(U_PPTV).value( U_PPTV );
         } else {
             H_LOG( logger, Logger::DEBUG ) << "Unknown variable " << varName << std::endl;
-            H_THROW( "Unknown variable name while parsing "+ getComponentName() + ": "
-                    + varName );
+            H_THROW( "Unknown variable name while parsing "+ gas_component[ i ] + ": "
+                    + var );
         }
     } catch( h_exception& parseException ) {
         H_RETHROW( parseException, "Could not parse var: "+varName );
@@ -137,15 +204,19 @@ void HalocarbonComponent::prepareToRun() {
     H_LOG( logger, Logger::DEBUG ) << "prepareToRun " << std::endl;
     oldDate = core->getStartDate();
 
-    H_ASSERT( tau != -1 && tau != 0, "tau has bad value" );
-    H_ASSERT( rho.units() != U_UNDEFINED, "rho has undefined units" );
-    H_ASSERT( molarMass > 0, "molarMass must be >0" );
-
-    Ha_ts.set(oldDate,H0);
+    for( int i = 0; i < ngas; ++i ) {
+        // Gases disabled in the input file are neither checked nor run
+        enabled[ i ] = core->componentEnabled( gas_component[ i ] );
+        if( !enabled[ i ] ) continue;
 
+        H_ASSERT( tau[ i ] != -1 && tau[ i ] != 0, gas_component[ i ] + ": tau has bad value" );
+        H_ASSERT( rho[ i ] == rho[ i ], gas_component[ i ] + ": rho has undefined units" );
+        H_ASSERT( molarMass[ i ] > 0, gas_component[ i ] + ": molarMass must be >0" );
+        decay[ i ] = exp( -( 1 / tau[ i ] ) );
+    }
 
-    //! \remark concentration values will not be allowed to interpolate beyond years already read in
-    //    concentration.allowPartialInterp( true );
+    conc_ts.assign( H0.begin(), H0.end() );
+    forcing_ts.assign( ngas, 0.0 );
 }
 
 //------------------------------------------------------------------------------
@@ -153,34 +224,48 @@ void HalocarbonComponent::prepareToRun() {
 void HalocarbonComponent::run( const double runToDate ) {
 	H_ASSERT( !core->inSpinup() && runToDate-oldDate == 1, "timestep must equal 1" );
     #define AtmosphereDryAirConstant 1.8
-
-    unitval Ha(Ha_ts.get(oldDate));
-    
-    // If emissions-forced, calculate concentration from emissions and lifespan.
-    if ( Ha_constrain.size() && Ha_constrain.exists( runToDate ) ) {
-        // Concentration-forced. Just grab the current value from the time series.
-        Ha = Ha_constrain.get(runToDate);
-    } else {
-        const double timestep = 1.0;
-        const double alpha = 1 / tau;
-
-        // Compute the delta atmospheric concentration from current emissions
-        double emissMol = emissions.get( runToDate ).value( U_GG ) / molarMass * timestep; // this is in U_GMOL
-        unitval concDeltaEmiss;
-        concDeltaEmiss.set( emissMol / ( 0.1 * AtmosphereDryAirConstant ), U_PPTV );
-    
-        // Update the atmospheric concentration, accounting for this delta and exponential decay
-        double expfac = exp(-alpha);
-        Ha = Ha*expfac + concDeltaEmiss*tau * (1.0-expfac);
+    const double timestep = 1.0;
+
+    // Gather this year's inputs: either a concentration constraint or the
+    // delta atmospheric concentration from current emissions
+    for( int i = 0; i < ngas; ++i ) {
+        if( !enabled[ i ] ) continue;
+        constrained[ i ] = Ha_constrain[ i ].size() && Ha_constrain[ i ].exists( runToDate );
+        if( constrained[ i ] ) {
+            // Concentration-forced. Just grab the current value from the time series.
+            emiss[ i ] = Ha_constrain[ i ].get( runToDate ).value( U_PPTV );
+        } else {
+            double emissMol = emissions[ i ].get( runToDate ).value( U_GG ) / molarMass[ i ] * timestep; // this is in U_GMOL
+            emiss[ i ] = emissMol / ( 0.1 * AtmosphereDryAirConstant );      // U_PPTV
+        }
     }
 
-    H_LOG( logger, Logger::DEBUG ) << "date: " << runToDate << " concentration: "<< Ha << endl;
-    Ha_ts.set(runToDate, Ha);
+    // Update the atmospheric concentrations, accounting for emissions and
+    // exponential decay, and the radiative forcings
+    const size_t prev = ( nrow() - 1 ) * ngas;
+    conc_ts.resize( prev + 2 * ngas );
+    forcing_ts.resize( prev + 2 * ngas );
+    const double *Hprev = &conc_ts[ prev ];
+    double *Ha = &conc_ts[ prev + ngas ];
+    double *rf = &forcing_ts[ prev + ngas ];
+    for( int i = 0; i < ngas; ++i ) {
+        if( !enabled[ i ] ) {
+            Ha[ i ] = rf[ i ] = 0.0;
+            continue;
+        }
+        if( constrained[ i ] ) {
+            Ha[ i ] = emiss[ i ];
+        } else {
+            Ha[ i ] = Hprev[ i ] * decay[ i ] + emiss[ i ] * tau[ i ] * ( 1.0 - decay[ i ] );
+        }
+        // TODO: this should be moved to forcing component
+        rf[ i ] = rho[ i ] * Ha[ i ];
+    }
 
-    // Calculate radiative forcing    TODO: this should be moved to forcing component
-    unitval rf;
-    rf.set( rho.value( U_W_M2_PPTV ) * Ha.value( U_PPTV ), U_W_M2 );
-    hc_forcing.set( runToDate, rf );
+    for( int i = 0; i < ngas; ++i ) {
+        H_LOG( logger, Logger::DEBUG ) << "date: " << runToDate << " " << gas_names[ i ]
+            << " concentration: " << Ha[ i ] << " pptv" << endl;
+    }
 
     // Update time counter.
     oldDate = runToDate;
@@ -198,33 +283,47 @@ unitval HalocarbonComponent::getData( const std::string& varName,
         getdate = oldDate;
     }
 
-    if( varName == D_RF_PREFIX+myGasName ) {
-        returnval = hc_forcing.get( getdate );
+    string var;
+    const int i = parse_gas( varName, var );
+    H_ASSERT( i >= 0, "Halocarbon not specified for " + varName );
+
+    const map<string, pair<int, gas_var> >::const_iterator gv = gas_vars.find( var );
+    const gas_var v = gv == gas_vars.end() ? HC_FORCING : gv->second.second;
+
+    // Row of the state arrays for the date, if it has been computed
+    const double row = ::round( getdate - core->getStartDate() );
+    const bool have_row = row >= 0 && row < nrow() && getdate <= oldDate;
+
+    if( gv != gas_vars.end() && v == HC_FORCING ) {
+        H_ASSERT( have_row, "Date not available for " + var );
+        returnval.set( forcing_ts[ size_t( row ) * ngas + i ], U_W_M2 );
     }
-    else if( varName == D_PREINDUSTRIAL_HC ) {
+    else if( var == D_PREINDUSTRIAL_HC ) {
         // use date as input, not getdate, b/c there should be no date specified.
         H_ASSERT( date == Core::undefinedIndex(), "Date not allowed for preindustrial hc" );
-        returnval = H0;
+        returnval.set( H0[ i ], U_PPTV );
     }
-    else if( varName == myGasName+CONCENTRATION_EXTENSION ) {
+    else if( gv != gas_vars.end() && v == HC_CONCENTRATION ) {
         H_ASSERT( date != Core::undefinedIndex(), "Date required for halocarbon concentration" );
-        returnval = Ha_ts.get( getdate );
+        H_ASSERT( have_row, "Date not available for " + var );
+        returnval.set( conc_ts[ size_t( row ) * ngas + i ], U_PPTV );
     }
-    else if( varName == myGasName+EMISSIONS_EXTENSION ) {
-        if( emissions.exists( getdate ) )
-            returnval = emissions.get( getdate );
+    else if( gv != gas_vars.end() && v == HC_EMISSIONS ) {
+        if( emissions[ i ].exists( getdate ) )
+            returnval = emissions[ i ].get( getdate );
         else
             returnval.set( 0.0, U_GG );
     }
-    else if( varName == D_HC_CONCENTRATION ) {
-            returnval = Ha_ts.get(getdate);
+    else if( var == D_HC_CONCENTRATION ) {
+        H_ASSERT( have_row, "Date not available for " + varName );
+        returnval.set( conc_ts[ size_t( row ) * ngas + i ], U_PPTV );
     }
-    else if( varName == myGasName+CONC_CONSTRAINT_EXTENSION ) {
+    else if( gv != gas_vars.end() && v == HC_CONSTRAIN ) {
         H_ASSERT( date != Core::undefinedIndex(), "Date required for halocarbon constraint" );
-        if ( Ha_constrain.exists( getdate ) ) {
-            returnval = Ha_constrain.get( getdate );
+        if ( Ha_constrain[ i ].exists( getdate ) ) {
+            returnval = Ha_constrain[ i ].get( getdate );
         } else {
-            H_LOG( logger, Logger::DEBUG ) << "No CH4 constraint for requested date " << date <<
+            H_LOG( logger, Logger::DEBUG ) << "No " << gas_names[ i ] << " constraint for requested date " << date <<
                 ". Returning missing value." << std::endl;
             returnval.set( MISSING_FLOAT, U_PPTV );
         }
@@ -239,10 +338,13 @@ unitval HalocarbonComponent::getData( const std::string& varName,
 
 void HalocarbonComponent::reset(double time)
 {
-    // reset time counter and truncate outputs
+    // reset time counter and truncate outputs; the preindustrial row is
+    // always kept
     oldDate = time;
-    hc_forcing.truncate(time);
-    Ha_ts.truncate(time);
+    const double row = ::round( time - core->getStartDate() );
+    const size_t keep = row > 0 ? min( size_t( row ) + 1, nrow() ) : 1;
+    conc_ts.resize( keep * ngas );
+    forcing_ts.resize( keep * ngas );
     H_LOG(logger, Logger::NOTICE)
         << getComponentName() << " reset to time= " << time << "\n";
 }
@@ -261,53 +363,4 @@ void HalocarbonComponent::accept( AVisitor* visitor ) {
     visitor->visit( this );
 }
 
-
-//------------------------------------------------------------------------------
-/* \brief                       Calculate the derivative of this halocarbon at the
- *                              current date given the current concentration
- * \param[in] currConcentration The current concentration at the current date
- * \param[in] currDate          The current date.
- * \return                      change from current concentration
- *
- *  The change from the current concentration is computed by by adding emissions
- *  and assuming a constant decay of the halocarbons currently in the atmosphere.
- */
-/*
- unitval HalocarbonComponent::getChangeInConcentration( unitval currConcentration, double currDate ) const
- {
- #define AtmosphereDryAirConstant 1.8
-
- const double timestep = 1.0;
- const double alpha = 1 / tau;
-
- unitval cumulativeEmissMol;
- cumulativeEmissMol.set( emissions.get( currDate ).value( U_GG ) / molarMass * timestep, U_GMOL );
-
- unitval concFromEmiss;
- concFromEmiss.set( cumulativeEmissMol.value( U_GMOL ) / ( 0.1 * AtmosphereDryAirConstant ), U_PPTV );
-
- return currConcentration * -alpha + concFromEmiss;
- }
- */
-
-//------------------------------------------------------------------------------
-/* \brief               Runge-Kutta approximation
- * \param[in] time1     The start year which we assume we have already have a concentration
- * \param[in] time2     The end year in which we want to approximate a concentration
- * \return              The approximate solution
- *
- * A simple Runge-Kutta to approximate the concentration over some time step.
- */
-/*
- unitval HalocarbonComponent::rk( double time1, double time2 ) const {
- const double h = 1; // relates to time2?
- unitval currConcentration = concentration.get( time1 );
- unitval k0 = getChangeInConcentration( currConcentration, time1 );
- unitval k1 = getChangeInConcentration( currConcentration + k0 * 0.5, time1 + 0.5 * h );
- unitval k2 = getChangeInConcentration( currConcentration + k1 * 0.5, time1 + 0.5 * h );
- unitval k3 = getChangeInConcentration( currConcentration + k2, time1 + h );
- return currConcentration + ( k0 + k1 * 2.0 + k2 * 2.0 + k3 ) / 6.0;
- }
- */
-
 }
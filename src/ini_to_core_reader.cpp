@@ -16,21 +16,17 @@
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/algorithm/string/trim.hpp>
 
-// ANS: If using the R package, use Rcpp to call R's file processing
-// functions. Otherwise (e.g. if building standalone Hector), fall
-// back to boost::filesystem (which needs to be installed).
-#ifdef USE_RCPP
-#include <Rcpp.h>
-#else
-#include <boost/filesystem.hpp>
-namespace fs = boost::filesystem;
-#endif
+#include <cstdlib>
+#include <climits>
+#include <sys/stat.h>
 
 #include "core.hpp"
 #include "message_data.hpp"
 #include "ini_to_core_reader.hpp"
 #include "ini.h"
 #include "csv_table_reader.hpp"
+#include "scenario_bundle.hpp"
+#include "component_data.hpp"
 
 namespace Hector {
 
@@ -40,9 +36,10 @@ using namespace std;
 /*! \brief Constructor
  *
  *  Sets a pointer to the Core object which will handle routing read in data to
- *  the correct setData
+ *  the correct setData.  The core may be null if the reader is only used to
+ *  record scenario bundles.
  */
-INIToCoreReader::INIToCoreReader( Core* core ):core( core )
+INIToCoreReader::INIToCoreReader( Core* core ):core( core ), bundle( 0 )
 {
 }
 
@@ -56,13 +53,66 @@ INIToCoreReader::~INIToCoreReader() {
 //------------------------------------------------------------------------------
 /*! \brief Parse and INI file at the given name filename and route the data through
  *         the core.
+ *
+ *  The file may also be a scenario bundle (see ScenarioBundle), in which case
+ *  its contents are routed through the core.
+ *
  *  \param filename The INI file to be parsed by the core.
  *  \exception h_exception If either there was an error reading the INI file or
  *                         or there was a problem in the Core trying to set the
  *                         data.
  */
 void INIToCoreReader::parse( const string& filename ) {
+    H_ASSERT( core, "core pointer is null!" );
+    if( ScenarioBundle::isBundle( filename ) ) {
+        ScenarioBundle scenario;
+        scenario.read( filename );
+        scenario.apply( core );
+        return;
+    }
+    parseINI( filename );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Parse an INI file into a scenario bundle instead of the core.
+ *
+ *  The values that parse would route through the core, including the
+ *  contents of any input tables, are added to the bundle.
+ *
+ *  \param filename The INI file to be parsed.
+ *  \param scenario The bundle to add to.
+ *  \exception h_exception If there was an error reading the INI file or its
+ *                         tables.
+ */
+void INIToCoreReader::record( const string& filename, ScenarioBundle& scenario ) {
+    bundle = &scenario;
+    try {
+        parseINI( filename );
+    } catch( ... ) {
+        bundle = 0;
+        throw;
+    }
+    bundle = 0;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Parse an INI file, handing each value to valueHandler.
+ *  \param filename The INI file to be parsed.
+ *  \exception h_exception If either there was an error reading the INI file or
+ *                         or there was a problem handling a value.
+ */
+void INIToCoreReader::parseINI( const string& filename ) {
     iniFilePath = filename;
+    iniDirectory.clear();
+    resolvedFileNames.clear();
+
+    // Load all the tables the file refers to up front, in parallel.  Errors
+    // are left to be reported, in context, by the pass below.
+    csvFileNames.clear();
+    if( ini_parse( filename.c_str(), fileNameHandler, this ) == 0 ) {
+        CSVTableReader::preload( csvFileNames );
+    }
+
     int errorCode = ini_parse( filename.c_str(), valueHandler, this );
 
     // handle c errors by turning them into exceptions which can be handled later
@@ -89,18 +139,9 @@ void INIToCoreReader::parse( const string& filename ) {
 int INIToCoreReader::valueHandler( void* user, const char* section, const char* name,
                                   const char* value )
 {
-    #ifdef USE_RCPP
-    // Load R functions for path management
-    Rcpp::Environment base("package:base");
-    Rcpp::Function normalizePath = base["normalizePath"];
-    Rcpp::Function dirname = base["dirname"];
-    Rcpp::Function filepath = base["file.path"];
-    #endif
-
     static const string csvFilePrefix = "csv:";
     INIToCoreReader* reader = (INIToCoreReader*)user;
 
-    H_ASSERT( reader->core, "core pointer is null!" );
     string nameStr = name;
     string valueStr = value;
     StringIter startBracket = find( nameStr.begin(), nameStr.end(), '[' );
@@ -116,57 +157,49 @@ int INIToCoreReader::valueHandler( void* user, const char* section, const char*
             // substring the first part of name before the open bracket which is the
             // actual variable name the core knows about
             nameStr = string( static_cast<StringIter>( nameStr.begin() ), startBracket );
-            message_data data( valueStr );
-            data.date = valueIndex;
-            reader->core->setData( section, nameStr, data );
+            if( reader->bundle ) {
+                reader->bundle->addValue( section, nameStr, valueStr, valueIndex );
+            } else {
+                message_data data( valueStr );
+                data.date = valueIndex;
+                reader->core->setData( section, nameStr, data );
+            }
         } else if( boost::starts_with( valueStr, csvFilePrefix ) ) {
             // the variableName = csv:input/table.csv case
 
             // remove the special case identifier to figure out the actual file name
             // to process
-            string csvFileName( valueStr.begin() + csvFilePrefix.size(), valueStr.end() );
-            #ifdef USE_RCPP
-            // ANS: This is the algorithm used if Hector is compiled
-	    // as an R package.
-            //
-	    // If the csvFileName normalizes to a real path, use that.
-            // Otherwise, assume that it is pointing to a file in the
-            // same directory as the INI file.
-            try {
-                // Second argument is "winslash", which is only used
-                // on Windows machines and is ignored for Unix-based
-                // systems. "\\" (single backward slash) is the
-                // default. Need it here to access the third argument
-                // -- mustWork -- which throws the error to be caught
-                // if the path doesn't exist
-                csvFileName = Rcpp::as<string>(normalizePath(csvFileName, "\\", true));
-            } catch (...) {
-                // Get the full path of the INI file with
-                // normalizePath. Then, get just the directory using dirname.
-                Rcpp::String parentPath = dirname(normalizePath(reader->iniFilePath));
-                csvFileName = Rcpp::as<string>(filepath(parentPath, csvFileName));
-            }
-            #else
-            // ANS:: Algorithm for standalone Hector. Same logic -- if
-            // the given path (absolute or relative) points to a file
-            // that exists, use that. Otherwise, assume that the path
-            // is relative to the INI file's directory.
-            fs::path csvFilePath( csvFileName );
-            if ( !fs::exists(csvFilePath) ) {
-              fs::path iniFilePath( reader->iniFilePath );
-              fs::path fullPath( iniFilePath.parent_path() / csvFilePath );
-              csvFileName = fullPath.string();
-            }
-            #endif
+            string csvFileName = reader->resolveFileName(
+                string( valueStr.begin() + csvFilePrefix.size(), valueStr.end() ) );
 
-            CSVTableReader tableReader( csvFileName );
-            tableReader.process( reader->core, section, nameStr );
+            if( nameStr == D_LAND_CELLS || nameStr == D_TEMP_PATTERN ) {
+                // Land cell tables and temperature patterns are not time
+                // series; pass the resolved file name along and let the
+                // component read it.  Bundles keep the whole file.
+                if( reader->bundle ) {
+                    reader->bundle->addFile( section, nameStr, csvFileName );
+                } else {
+                    message_data data( csvFileName );
+                    reader->core->setData( section, nameStr, data );
+                }
+            } else {
+                CSVTableReader tableReader( csvFileName );
+                if( reader->bundle ) {
+                    tableReader.record( *reader->bundle, section, nameStr );
+                } else {
+                    tableReader.process( reader->core, section, nameStr );
+                }
+            }
         } else {
             // the typical variableName = value case
             // note that this implies name is not a time series variable and the
             // index will be left as the default uninitialized constant
-            message_data data( valueStr );
-            reader->core->setData( section, name, data );
+            if( reader->bundle ) {
+                reader->bundle->addValue( section, name, valueStr, Core::undefinedIndex() );
+            } else {
+                message_data data( valueStr );
+                reader->core->setData( section, name, data );
+            }
         }
     }
     catch(const h_exception& e) {
@@ -182,6 +215,109 @@ int INIToCoreReader::valueHandler( void* user, const char* section, const char*
     return 1;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Private call back collecting the time series tables an INI file
+ *         refers to.
+ *
+ *  Used by parse to find the tables to preload; the values are not routed.
+ *
+ *  \param user The instance of the parser who initiated the call back.
+ *  \param section The INI section (component name, as interpreted by the core)
+ *  \param name The name of the variable.
+ *  \param value The value of the variable to set.
+ */
+int INIToCoreReader::fileNameHandler( void* user, const char* section, const char* name,
+                                      const char* value )
+{
+    static const string csvFilePrefix = "csv:";
+    INIToCoreReader* reader = (INIToCoreReader*)user;
+
+    string nameStr = name;
+    string valueStr = value;
+    if( boost::starts_with( valueStr, csvFilePrefix ) &&
+        nameStr != D_LAND_CELLS && nameStr != D_TEMP_PATTERN ) {
+        reader->csvFileNames.push_back( reader->resolveFileName(
+            string( valueStr.begin() + csvFilePrefix.size(), valueStr.end() ) ) );
+    }
+    return 1;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Get the canonical absolute name of an existing file.
+ *
+ *  Equivalent to R's normalizePath( path, mustWork = TRUE ), without calling
+ *  into R.
+ *
+ *  \param path The file name to normalize.
+ *  \param normalized Set to the normalized name.
+ *  \return Whether the file exists (otherwise normalized is unchanged).
+ */
+static bool normalize_path( const string& path, string& normalized ) {
+#ifdef _WIN32
+    char buf[ _MAX_PATH ];
+    struct _stat st;
+    if( !_fullpath( buf, path.c_str(), _MAX_PATH ) || _stat( buf, &st ) != 0 ) {
+        return false;
+    }
+    normalized = buf;
+#else
+    char* resolved = realpath( path.c_str(), NULL );
+    if( !resolved ) {
+        return false;
+    }
+    normalized = resolved;
+    free( resolved );
+#endif
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Get the directory part of a file name, as R's dirname does.
+ */
+static string directory_name( const string& path ) {
+    const size_t sep = path.find_last_of( "/\\" );
+    if( sep == string::npos ) {
+        return ".";
+    }
+    return sep == 0 ? path.substr( 0, 1 ) : path.substr( 0, sep );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Find the file a csv: value refers to.
+ *
+ *  If the given path (absolute or relative to the working directory) points
+ *  to a file that exists, use that.  Otherwise, assume that the path is
+ *  relative to the INI file's directory.  Names of files that exist are made
+ *  canonical, since tables are cached by file name.  This is done natively,
+ *  in both the standalone and R builds, and the result for each distinct name
+ *  is remembered for the rest of the parse.
+ *
+ *  \param csvFileName The file name following the csv: identifier.
+ *  \return The file name to read.
+ */
+string INIToCoreReader::resolveFileName( string csvFileName ) {
+    // Many keys usually name the same file
+    map<string, string>::const_iterator found = resolvedFileNames.find( csvFileName );
+    if( found != resolvedFileNames.end() ) {
+        return found->second;
+    }
+
+    string resolved;
+    if( !normalize_path( csvFileName, resolved ) ) {
+        if( iniDirectory.empty() ) {
+            string iniPath;
+            iniDirectory = directory_name( normalize_path( iniFilePath, iniPath ) ? iniPath : iniFilePath );
+        }
+        const string fullPath = iniDirectory + "/" + csvFileName;
+        if( !normalize_path( fullPath, resolved ) ) {
+            // reported when the file is read
+            resolved = fullPath;
+        }
+    }
+    resolvedFileNames[ csvFileName ] = resolved;
+    return resolved;
+}
+
 //------------------------------------------------------------------------------
 /*! \brief Parse a single time series index from a variable name.
  *
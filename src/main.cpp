@@ -20,7 +20,11 @@
 #include "h_util.hpp"
 #include "h_reader.hpp"
 #include "ini_to_core_reader.hpp"
+#include "scenario_bundle.hpp"
 #include "csv_outputstream_visitor.hpp"
+#include "gridded_output_visitor.hpp"
+#include "binary_output_visitor.hpp"
+#include "wide_csv_output_visitor.hpp"
 
 #include "unitval.hpp"
 
@@ -40,17 +44,55 @@ int main (int argc, char * const argv[]) {
         Logger& glog = core.getGlobalLogger();
         H_LOG( glog, Logger::NOTICE ) << MODEL_NAME << " wrapper start" << endl;
 
-        // Parse the main configuration file
-        if( argc > 1 ) {
-            if( ifstream( argv[1] ) ) {
-                h_reader reader( argv[1], INI_style );
+        // Write a scenario bundle instead of running
+        if( argc == 4 && string( argv[1] ) == "--bundle" ) {
+            H_LOG( glog, Logger::NOTICE ) << "Writing scenario bundle " << argv[3] << " from " << argv[2] << endl;
+            ScenarioBundle scenario;
+            INIToCoreReader bundleParser( 0 );
+            bundleParser.record( argv[2], scenario );
+            scenario.write( argv[3] );
+            glog.close();
+            return 0;
+        }
+
+        // Options: --binary writes binary output instead of csv, --wide
+        // writes a wide csv table (one row per year) instead, and
+        // --vars <list> writes only the listed variables
+        bool binaryOutput = false;
+        bool wideOutput = false;
+        bool subscribed = false;
+        vector<string> outputVars;
+        int argi = 1;
+        while( argi < argc - 1 ) {
+            const string option( argv[argi] );
+            if( option == "--binary" ) {
+                binaryOutput = true;
+                ++argi;
+            } else if( option == "--wide" ) {
+                wideOutput = true;
+                ++argi;
+            } else if( option == "--vars" && argi < argc - 2 ) {
+                outputVars = OutputSubscription::parse( argv[argi + 1] );
+                subscribed = true;
+                argi += 2;
+            } else {
+                break;
+            }
+        }
+
+        // Parse the main configuration file (an INI file or scenario bundle)
+        if( argc > argi ) {
+            if( ScenarioBundle::isBundle( argv[argi] ) ) {
+                // read when routed to the core
+            } else if( ifstream( argv[argi] ) ) {
+                h_reader reader( argv[argi], INI_style );
             } else {
-                H_LOG( glog, Logger::SEVERE ) << "Couldn't find input file " << argv[ 1 ] << endl;
+                H_LOG( glog, Logger::SEVERE ) << "Couldn't find input file " << argv[ argi ] << endl;
                 H_THROW( "Couldn't find input file" )
             }
         } else {
             H_LOG( glog, Logger::SEVERE ) << "No configuration filename!" << endl;
-            H_THROW( "Usage: <program> <config file name>" )
+            H_THROW( "Usage: <program> [--binary] [--wide] [--vars <variables>] <config file name>\n       <program> --bundle <config file name> <bundle file name>" )
         }
 
         // Initialize the core and send input data to it
@@ -59,7 +101,7 @@ int main (int argc, char * const argv[]) {
 
         H_LOG( glog, Logger::NOTICE ) << "Setting data in the core." << endl;
         INIToCoreReader coreParser( &core );
-        coreParser.parse( argv[1] );
+        coreParser.parse( argv[argi] );
 
         // Create visitors
         H_LOG( glog, Logger::NOTICE ) << "Adding visitors to the core." << endl;
@@ -67,21 +109,47 @@ int main (int argc, char * const argv[]) {
 
         // Open the stream output file, which has an optional run name (specified in the INI file) in it
         string rn = core.getRun_name();
-        if( rn == "" )
-            csvoutputStreamFile.open( string( string( OUTPUT_DIRECTORY ) + "outputstream.csv" ).c_str(), ios::out );
-        else
-            csvoutputStreamFile.open( string( string( OUTPUT_DIRECTORY ) + "outputstream_" + rn + ".csv" ).c_str(), ios::out );
+        string outputName = string( OUTPUT_DIRECTORY ) + ( rn == "" ? "outputstream" : "outputstream_" + rn );
+        const bool longOutput = !binaryOutput && !wideOutput;
+        if( longOutput )
+            csvoutputStreamFile.open( ( outputName + ".csv" ).c_str(), ios::out );
 
 
         ostream outputStream( &csvoutputStreamFile );
-        CSVOutputStreamVisitor csvOutputStreamVisitor( outputStream );
-        core.addVisitor( &csvOutputStreamVisitor );
+        CSVOutputStreamVisitor csvOutputStreamVisitor( outputStream, longOutput );
+        if( subscribed )
+            csvOutputStreamVisitor.subscribe( outputVars );
+        if( longOutput )
+            core.addVisitor( &csvOutputStreamVisitor );
+
+        // Binary stream output, written at the end of the run
+        BinaryOutputVisitor binaryOutputVisitor( outputName + ".hbo" );
+        if( subscribed )
+            binaryOutputVisitor.subscribe( outputVars );
+        if( binaryOutput )
+            core.addVisitor( &binaryOutputVisitor );
+
+        // Wide csv output, also written at the end of the run
+        WideCSVOutputVisitor wideOutputVisitor( outputName + "_wide.csv" );
+        if( subscribed )
+            wideOutputVisitor.subscribe( outputVars );
+        if( wideOutput )
+            core.addVisitor( &wideOutputVisitor );
+
+        // Gridded temperature output, written only if a temperature pattern was given
+        string gridFileName = string( OUTPUT_DIRECTORY ) + ( rn == "" ? "gridded_temp.bin" : "gridded_temp_" + rn + ".bin" );
+        GriddedOutputVisitor griddedOutputVisitor( gridFileName );
+        core.addVisitor( &griddedOutputVisitor );
 
         H_LOG(glog, Logger::NOTICE) << "Calling prepareToRun()\n";
         core.prepareToRun();
 
         H_LOG( glog, Logger::NOTICE ) << "Running the core." << endl;
         core.run();
+        if( binaryOutput )
+            binaryOutputVisitor.close();
+        if( wideOutput )
+            wideOutputVisitor.close();
 
         H_LOG( glog, Logger::NOTICE ) << "Hector wrapper end" << endl;
         glog.close();
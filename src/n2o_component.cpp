@@ -34,6 +34,7 @@ N2OComponent::N2OComponent() {
     N2O.name = D_ATMOSPHERIC_N2O;
     TAU_N2O.allowInterp( true );
     TAU_N2O.name = D_TAU_N2O;
+    chemistry = 0;
   }
 
 //------------------------------------------------------------------------------
@@ -141,6 +142,7 @@ void N2OComponent::prepareToRun() {
         N0 = N2O_constrain.get( oldDate );
     }
     N2O.set( oldDate, N0 );
+    chemistry = AtmosChemistry::find( core );
 }
 
 //------------------------------------------------------------------------------
@@ -148,6 +150,11 @@ void N2OComponent::prepareToRun() {
 void N2OComponent::run( const double runToDate ) {
 
 	H_ASSERT( !core->inSpinup() && runToDate-oldDate == 1, "timestep must equal 1" );
+    if( chemistry ) {
+        chemistry->run( runToDate );
+        oldDate = runToDate;
+        return;
+    }
 
     if ( N2O_constrain.size() && N2O_constrain.exists( runToDate ) ) {
         N2O.set( runToDate, N2O_constrain.get( runToDate ) );
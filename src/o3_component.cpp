@@ -27,6 +27,7 @@ using namespace std;
 /*! \brief Constructor
  */
 OzoneComponent::OzoneComponent() {
+    chemistry = 0;
 }
 
 //------------------------------------------------------------------------------
@@ -125,12 +126,19 @@ void OzoneComponent::prepareToRun() {
     H_LOG( logger, Logger::DEBUG ) << "prepareToRun " << std::endl;
     oldDate = core->getStartDate();
     O3.set(oldDate, PO3);  // set the first year's value
+    chemistry = AtmosChemistry::find( core );
 }
 
 //------------------------------------------------------------------------------
 // documentation is inherited
 void OzoneComponent::run( const double runToDate ) {
 
+    if( chemistry ) {
+        chemistry->run( runToDate );
+        oldDate = runToDate;
+        return;
+    }
+
 	// Calculate O3 based on NOX, CO, NMVOC, CH4.
     // Modified from Tanaka et al 2007
 
@@ -69,6 +69,7 @@ void OceanComponent::init( Core* coreptr ) {
     Tgav.set( 0.0, U_DEGC );
 
 	lastflux_annualized.set( 0.0, U_PGC );
+    chem_skipped = false;
 
     // Register the data we can provide
     core->registerCapability( D_OCEAN_CFLUX, getComponentName() );
@@ -185,6 +186,9 @@ void OceanComponent::prepareToRun() {
 
     H_LOG( logger, Logger::DEBUG ) << "prepareToRun " << std::endl;
 
+    atmos_model = dynamic_cast<CarbonCycleModel*>( core->getComponentByCapability( D_ATMOSPHERIC_C ) );
+    H_ASSERT( atmos_model, "atmospheric carbon model is not a carbon cycle model" );
+
     // Set up our ocean box model. Carbon values here can be overridden by user input
     H_LOG( logger, Logger::DEBUG ) << "Setting up ocean box model" << std::endl;
     surfaceHL.initbox( unitval( 140, U_PGC ), "HL" );
@@ -307,6 +311,14 @@ void OceanComponent::run( const double runToDate ) {
 	annualflux_sumLL.set( 0.0, U_PGC );
     timesteps = 0;
 
+    // The carbon cycle isn't run in years with prescribed CO2 in a
+    // concentration-driven run, so there is no flux to compute, and the
+    // chemistry outputs are reported as missing
+    chem_skipped = core->concentrationDriven() && !in_spinup && atmos_model->atmosphere_prescribed( runToDate );
+    if( chem_skipped ) {
+        return;
+    }
+
     // Initialize ocean box boundary conditions and inform them new year starting
     H_LOG(logger, Logger::DEBUG) << "Starting new year: Tgav= " << Tgav << std::endl;
     surfaceHL.new_year( Tgav );
@@ -368,17 +380,17 @@ unitval OceanComponent::getData( const std::string& varName,
          } else if( varName == D_TWI ) {
             returnval = twi;
         } else if( varName == D_OMEGACA_HL ) {
-            returnval = surfaceHL.mychemistry.OmegaCa;
+            returnval = chem_output( surfaceHL.mychemistry.OmegaCa );
         } else if( varName == D_OMEGACA_LL ) {
-            returnval = surfaceLL.mychemistry.OmegaCa;
+            returnval = chem_output( surfaceLL.mychemistry.OmegaCa );
         } else if( varName == D_OMEGAAR_HL ) {
-            returnval = surfaceHL.mychemistry.OmegaAr;
+            returnval = chem_output( surfaceHL.mychemistry.OmegaAr );
         } else if( varName == D_OMEGAAR_LL ) {
-            returnval = surfaceLL.mychemistry.OmegaAr;
+            returnval = chem_output( surfaceLL.mychemistry.OmegaAr );
         } else if( varName == D_REVELLE_HL ) {
-            returnval = surfaceHL.calc_revelle();
+            returnval = chem_output( surfaceHL.calc_revelle() );
         } else if( varName == D_REVELLE_LL ) {
-            returnval = surfaceLL.calc_revelle();
+            returnval = chem_output( surfaceLL.calc_revelle() );
         } else if( varName == D_ATM_OCEAN_FLUX_HL ) {
             returnval = unitval( annualflux_sumHL.value( U_PGC ), U_PGC_YR );
         } else if( varName == D_ATM_OCEAN_FLUX_LL ) {
@@ -392,29 +404,29 @@ unitval OceanComponent::getData( const std::string& varName,
         } else if( varName == D_CARBON_IO ) {
         returnval = inter.get_carbon();
         } else if( varName == D_DIC_HL ) {
-            returnval = surfaceHL.mychemistry.convertToDIC( surfaceHL.get_carbon() );
+            returnval = chem_output( surfaceHL.mychemistry.convertToDIC( surfaceHL.get_carbon() ) );
         } else if( varName == D_DIC_LL ) {
-        returnval = surfaceLL.mychemistry.convertToDIC( surfaceLL.get_carbon() );
+        returnval = chem_output( surfaceLL.mychemistry.convertToDIC( surfaceLL.get_carbon() ) );
         } else if( varName == D_HL_DO ) {
-            returnval = surfaceHL.annual_box_fluxes[ &deep ] ;
+            returnval = chem_output( surfaceHL.annual_box_fluxes[ &deep ] );
         } else if( varName == D_PCO2_HL ) {
-            returnval = surfaceHL.mychemistry.PCO2o;
+            returnval = chem_output( surfaceHL.mychemistry.PCO2o );
         } else if( varName == D_PCO2_LL ) {
-            returnval = surfaceLL.mychemistry.PCO2o;
+            returnval = chem_output( surfaceLL.mychemistry.PCO2o );
         } else if( varName == D_PH_HL ) {
-               returnval = surfaceHL.mychemistry.pH;
+               returnval = chem_output( surfaceHL.mychemistry.pH );
         } else if( varName == D_PH_LL ) {
-               returnval = surfaceLL.mychemistry.pH;
+               returnval = chem_output( surfaceLL.mychemistry.pH );
         } else if( varName == D_TEMP_HL ) {
-            returnval = surfaceHL.get_Tbox();
+            returnval = chem_output( surfaceHL.get_Tbox() );
         } else if( varName == D_TEMP_LL ) {
-            returnval = surfaceLL.get_Tbox();
+            returnval = chem_output( surfaceLL.get_Tbox() );
         } else if( varName == D_OCEAN_C ) {
             returnval = totalcpool();
         } else if( varName == D_CO3_HL ) {
-        returnval = surfaceHL.mychemistry.CO3;
+        returnval = chem_output( surfaceHL.mychemistry.CO3 );
         } else if( varName == D_CO3_LL ) {
-            returnval = surfaceLL.mychemistry.CO3;
+            returnval = chem_output( surfaceLL.mychemistry.CO3 );
         } else if( varName == D_TIMESTEPS ) {
              returnval = unitval( timesteps, U_UNITLESS );
         } else {
@@ -524,8 +536,8 @@ void OceanComponent::slowparameval( double t, const double c[] ) {
 // documentation is inherited
 void OceanComponent::stashCValues( double t, const double c[] ) {
 
-    H_LOG( logger,Logger::DEBUG ) << "Stashing at t=" << t << ", model pools at " << t << ": " << c[ 0 ] << " "
-    << c[ 1 ] << " " << c[ 2 ] << " " << c[ 3 ] << " " << c[ 4 ] << " " << c[ 5 ] << std::endl;
+    H_LOG( logger,Logger::DEBUG ) << "Stashing at t=" << t << ", model pools at " << t << ": atmos " << c[ SNBOX_ATMOS ]
+    << " ocean " << c[ SNBOX_OCEAN ] << std::endl;
 
 	// At this point the solver has converged, going from ODEstartdate to t
     // Now we finalize calculations: circulate ocean, update carbon states, etc.
@@ -654,6 +666,40 @@ void OceanComponent::reset(double time)
         << getComponentName() << " reset to time= " << time << "\n";
 }
 
+//------------------------------------------------------------------------------
+/*! \brief      Get the spinup state
+ *  \details    Box carbon, then each box's carbon at the start of the last
+ *              step.  The connection fluxes use the latter, so both are
+ *              needed for the next year to follow from the state alone.
+ */
+void OceanComponent::getSpinupState( double x[] ) const
+{
+    const oceanbox* boxes[] = { &surfaceHL, &surfaceLL, &inter, &deep };
+    for( int i=0; i<4; ++i ) {
+        x[ i ] = boxes[ i ]->get_carbon().value( U_PGC );
+        x[ 4 + i ] = boxes[ i ]->previous_carbon();
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief      Set the spinup state
+ *  \details    The state is a trial iterate of the spinup solver, so it is
+ *              not logged or added to the boxes' history.
+ */
+void OceanComponent::setSpinupState( const double x[] )
+{
+    oceanbox* boxes[] = { &surfaceHL, &surfaceLL, &inter, &deep };
+    for( int i=0; i<4; ++i ) {
+        boxes[ i ]->restore_carbon( unitval( x[ i ], U_PGC ), x[ 4 + i ] );
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief         A chemistry output, or missing if the ocean wasn't run this year
+ */
+unitval OceanComponent::chem_output( const unitval& x ) const {
+    return chem_skipped ? unitval( MISSING_FLOAT, x.units() ) : x;
+}
 
 void OceanComponent::record_state(double time)
 {
@@ -675,18 +721,18 @@ void OceanComponent::record_state(double time)
     C_IO_ts.set(time, inter.get_carbon());
     Ca_HL_ts.set(time, surfaceHL.get_carbon());
     C_DO_ts.set(time, surfaceHL.annual_box_fluxes[ &deep ]);
-    PH_HL_ts.set(time, surfaceHL.mychemistry.pH);
-    PH_LL_ts.set(time, surfaceLL.mychemistry.pH);
-    pco2_HL_ts.set(time, surfaceHL.mychemistry.PCO2o);
-    pco2_LL_ts.set(time, surfaceLL.mychemistry.PCO2o);
-    dic_HL_ts.set(time, surfaceHL.mychemistry.convertToDIC( surfaceHL.get_carbon() ));
-    dic_LL_ts.set(time, surfaceLL.mychemistry.convertToDIC( surfaceLL.get_carbon() ));
+    PH_HL_ts.set(time, chem_output( surfaceHL.mychemistry.pH ));
+    PH_LL_ts.set(time, chem_output( surfaceLL.mychemistry.pH ));
+    pco2_HL_ts.set(time, chem_output( surfaceHL.mychemistry.PCO2o ));
+    pco2_LL_ts.set(time, chem_output( surfaceLL.mychemistry.PCO2o ));
+    dic_HL_ts.set(time, chem_output( surfaceHL.mychemistry.convertToDIC( surfaceHL.get_carbon() ) ));
+    dic_LL_ts.set(time, chem_output( surfaceLL.mychemistry.convertToDIC( surfaceLL.get_carbon() ) ));
     Ca_LL_ts.set(time, surfaceLL.get_carbon());
     C_DO_ts.set(time, deep.get_carbon());
-    temp_HL_ts.set(time, surfaceHL.get_Tbox());
-    temp_LL_ts.set(time, surfaceLL.get_Tbox());
-    co3_HL_ts.set(time, surfaceHL.mychemistry.CO3);
-    co3_LL_ts.set(time, surfaceLL.mychemistry.CO3);
+    temp_HL_ts.set(time, chem_output( surfaceHL.get_Tbox() ));
+    temp_LL_ts.set(time, chem_output( surfaceLL.get_Tbox() ));
+    co3_HL_ts.set(time, chem_output( surfaceHL.mychemistry.CO3 ));
+    co3_LL_ts.set(time, chem_output( surfaceLL.mychemistry.CO3 ));
 
     max_timestep_ts.set(time, max_timestep);
     reduced_timestep_timeout_ts.set(time, reduced_timestep_timeout);
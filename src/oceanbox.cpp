@@ -49,7 +49,31 @@ oceanbox::oceanbox() {
 void oceanbox::set_carbon( const unitval C) {
 	carbon = C;
 	OB_LOG( logger, Logger::WARNING ) << Name << " box C has been set to " << carbon << endl;
-	carbonHistory.insert( carbonHistory.begin(), C.value( U_PGC ) );
+	pushHistory( carbonHistory, C.value( U_PGC ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Carbon (Pg C) at the start of the last step
+ *
+ *  Connections with a window of 1 move carbon in proportion to this, so it
+ *  is part of the state that determines the next step.
+ */
+double oceanbox::previous_carbon() const {
+    return carbonHistory.empty() ? carbon.value( U_PGC ) : carbonHistory[ 0 ];
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Put the box in a given state, e.g. a spinup solver iterate
+ *  \param[in] C         current carbon
+ *  \param[in] previous  carbon at the start of the last step (Pg C)
+ *
+ *  Unlike set_carbon, nothing is logged or added to the history.
+ */
+void oceanbox::restore_carbon( const unitval C, const double previous ) {
+    carbon = C;
+    if( !carbonHistory.empty() ) {
+        carbonHistory[ 0 ] = previous;
+    }
 }
 
 //------------------------------------------------------------------------------
@@ -130,7 +154,7 @@ bool oceanbox::oscillating( const unsigned lookback, const double maxamp, const
  *  \returns                bool indicating whether box C is oscillating recently
  *  \exception              lookback must be non-negative
  */
-double oceanbox::vectorHistoryMean( std::vector<double> v, int lookback ) const {
+double oceanbox::vectorHistoryMean( const std::vector<double>& v, int lookback ) const {
     H_ASSERT( lookback > 0, "lookback must be >0" );
     H_ASSERT( v.size() > 0, "vector size must be >0" );
 
@@ -143,6 +167,21 @@ double oceanbox::vectorHistoryMean( std::vector<double> v, int lookback ) const
     return sum / lookback;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief          Record a past state at the front of a history vector
+ *  \param[in] v    history vector, most recent first
+ *  \param[in] x    value to record
+ *
+ *  Only the most recent OB_HISTORY_LENGTH states are kept, so memory (and the
+ *  cost of the box copies recorded every year) does not grow with run length.
+ */
+void oceanbox::pushHistory( std::vector<double>& v, const double x ) {
+    v.insert( v.begin(), x );
+    if( v.size() > OB_HISTORY_LENGTH ) {
+        v.pop_back();
+    }
+}
+
 //------------------------------------------------------------------------------
 /*! \brief          Add (or replace) a box-to-box connection
  *  \param[in] ob   pointer to another oceanbox
@@ -175,6 +214,7 @@ void oceanbox::make_connection( oceanbox* ob, const double k, const int ws ) { /
 	connection_list.push_back( ob ); // add new element to vector
 	connection_k.push_back( k );
 	H_ASSERT( ws >= 0, "window negative number" );
+	H_ASSERT( ws <= OB_HISTORY_LENGTH, "window longer than the box history" );
 	connection_window.push_back( ws );
 }
 
@@ -300,7 +340,7 @@ void oceanbox::compute_fluxes( const unitval current_Ca, const double yf, const
                 unitval( closs.value( U_PGC ), U_PGC_YR );
         } // for i
         
-        carbonLossHistory.insert( carbonLossHistory.begin (), closs_total.value( U_PGC ) );
+        pushHistory( carbonLossHistory, closs_total.value( U_PGC ) );
         
     } // if do_circulation
 }
@@ -330,7 +370,7 @@ unitval oceanbox::calc_revelle() {
  */
 void oceanbox::update_state() {
     
-	carbonHistory.insert( carbonHistory.begin (), carbon.value( U_PGC ) );
+	pushHistory( carbonHistory, carbon.value( U_PGC ) );
 	
 	carbon = carbon + CarbonToAdd + atmosphere_flux;
     
@@ -30,6 +30,8 @@ OHComponent::OHComponent() {
     NMVOC_emissions.allowInterp( true );
     CO_emissions.allowInterp( true );
     TAU_OH.allowInterp( true );
+    fused = false;
+    chemistry = 0;
 	//TOH0.set( 0.0, U_YRS );
 
 }
@@ -115,6 +117,9 @@ void OHComponent::setData( const string& varName,
          } else if( varName == D_COEFFICENT_NOX ) {
             H_ASSERT( data.date == Core::undefinedIndex(), "date not allowed" );
             CNOX = data.getUnitval(U_UNDEFINED);
+         } else if( varName == D_FUSED_CHEMISTRY ) {
+            H_ASSERT( data.date == Core::undefinedIndex(), "date not allowed" );
+            fused = ( data.getUnitval(U_UNDEFINED) > 0 );
          }	else {
             H_THROW( "Unknown variable name while parsing " + getComponentName() + ": "
                     + varName );
@@ -133,6 +138,9 @@ void OHComponent::prepareToRun() {
     //get intial CH4 concentration
     M0 = core->sendMessage( M_GETDATA, D_PREINDUSTRIAL_CH4 );
     TAU_OH.set( oldDate, TOH0 );
+
+    fused_chemistry.prepareToRun( core );
+    chemistry = AtmosChemistry::find( core );
  }
 
 //------------------------------------------------------------------------------
@@ -141,6 +149,11 @@ void OHComponent::run( const double runToDate )
 {
     H_LOG(logger, Logger::DEBUG) << "olddate:  " << oldDate << " runToDate: " << runToDate << std::endl;
     H_ASSERT( !core->inSpinup() && runToDate-oldDate == 1, "timestep must equal 1" );
+    if( chemistry ) {
+        chemistry->run( runToDate );
+        oldDate = runToDate;
+        return;
+    }
 
        // modified from Tanaka et al 2007 and Wigley et al 2002.
     unitval current_nox = NOX_emissions.get( runToDate );
@@ -196,6 +209,7 @@ unitval OHComponent::getData( const std::string& varName,
 void OHComponent::reset(double time)
 {
     oldDate = time;
+    fused_chemistry.reset( time );
     H_LOG(logger, Logger::NOTICE)
         << getComponentName() << " reset to time= " << time << "\n";
 }
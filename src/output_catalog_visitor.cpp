@@ -0,0 +1,274 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  output_catalog_visitor.cpp
+ *  hector
+ *
+ */
+
+#include "forcing_component.hpp"
+#include "halocarbon_component.hpp"
+#include "temperature_component.hpp"
+#include "slr_component.hpp"
+#include "o3_component.hpp"
+#include "oh_component.hpp"
+#include "ch4_component.hpp"
+#include "n2o_component.hpp"
+#include "ocean_component.hpp"
+#include "core.hpp"
+#include "simpleNbox.hpp"
+#include "output_catalog_visitor.hpp"
+
+namespace Hector {
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+/*! \brief Constructor
+ */
+OutputCatalogVisitor::OutputCatalogVisitor()
+:current_date( 0 ), in_spinup( false ), core( 0 )
+{
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Destructor
+ */
+OutputCatalogVisitor::~OutputCatalogVisitor() {
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Output only some variables
+ *
+ *  Overrides the core's output_variables setting.
+ *
+ *  \param vars The variables to output (see OutputSubscription); empty for
+ *              all of them.
+ */
+void OutputCatalogVisitor::subscribe( const vector<string>& vars ) {
+    subscription.set( vars );
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+bool OutputCatalogVisitor::shouldVisit( const bool is, const double date ) {
+    current_date = date;
+    in_spinup = is;
+
+    // visit all model periods
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+void OutputCatalogVisitor::visit( Core* c ) {
+    run_name = c->getRun_name();
+    core = c;
+    if( !subscription.isSet() ) {
+        // nothing subscribed directly: use the core's output_variables
+        subscription.set( c->getOutputVariables() );
+    }
+}
+
+// Each macro outputs a variable only if it is subscribed; `wanted` is the
+// filter of the component being visited
+
+// Output a variable with associated unitval units
+// Takes c (component), xname (variable name), x (output variable)
+#define OUTPUT_UNITVAL( c, xname, x ) \
+    { if( wanted( xname ) ) output( c->getComponentName(), xname, x ); }
+
+// Output a variable of component c, retrieved through sendMessage
+// Takes c (component), xname (variable name)
+#define OUTPUT_MESSAGE( c, xname ) \
+    { if( wanted( xname ) ) output( c->getComponentName(), xname, c->sendMessage( M_GETDATA, xname ) ); }
+
+// Output a date-dependent variable of component c for the current period
+// Takes c (component), xname (variable name), date
+#define OUTPUT_MESSAGE_DATE( c, xname, date ) \
+    { if( wanted( xname ) ) output( c->getComponentName(), xname, c->sendMessage( M_GETDATA, xname, message_data( date ) ) ); }
+
+// Output a date-dependent variable of component c for an earlier period
+// Takes c (component), xname (variable name), date
+#define OUTPUT_MESSAGE_EARLIER( c, xname, date ) \
+    { if( wanted( xname ) ) output( c->getComponentName(), xname, c->sendMessage( M_GETDATA, xname, message_data( date ) ), date ); }
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+void OutputCatalogVisitor::visit( ForcingComponent* c ) {
+    if( !core->outputEnabled( c->getComponentName() ) ) return;
+    const OutputSubscription::Filter& wanted = subscription.forComponent( c->getComponentName() );
+    if( !wanted.any() ) return;
+    if( c->currentYear < c->baseyear ) return;
+
+    // Walk through the forcing agents, outputting everything computed
+    const double *forcings = c->forcings_at( c->currentYear );
+    for( int i = 0; i < ForcingComponent::N_FORCING_AGENTS; ++i ) {
+        if( c->agent_present[ i ] ) {
+            OUTPUT_UNITVAL( c, ForcingComponent::forcing_names[ i ], unitval( forcings[ i ], U_W_M2 ) );
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+void OutputCatalogVisitor::visit( SimpleNbox* c ) {
+    if( !core->outputEnabled( c->getComponentName() ) ) return;
+    const OutputSubscription::Filter& wanted = subscription.forComponent( c->getComponentName() );
+    if( !wanted.any() ) return;
+
+    // Global outputs
+    OUTPUT_MESSAGE( c, D_LAND_CFLUX );
+    OUTPUT_MESSAGE( c, D_NPP );
+    OUTPUT_MESSAGE( c, D_RH );
+    OUTPUT_MESSAGE( c, D_ATMOSPHERIC_CO2 );
+    OUTPUT_MESSAGE( c, D_ATMOSPHERIC_C );
+    OUTPUT_MESSAGE( c, D_ATMOSPHERIC_C_RESIDUAL );
+    OUTPUT_MESSAGE( c, D_VEGC );
+    OUTPUT_MESSAGE( c, D_DETRITUSC );
+    OUTPUT_MESSAGE( c, D_SOILC );
+    OUTPUT_MESSAGE( c, D_EARTHC );
+
+    // Biome-specific outputs: <variable>.<biome>
+    if( c->nbiomes() > 1 ) {
+        for( int i = 0; i < c->nbiomes(); i++ ) {
+            const string& biome = c->biome_list[ i ];
+            OUTPUT_UNITVAL( c, biome+"."+D_NPP, c->npp( i ) );
+            OUTPUT_UNITVAL( c, biome+"."+D_RH, c->rh( i ) );
+            OUTPUT_UNITVAL( c, biome+"."+D_VEGC, unitval( c->veg_c[ i ], U_PGC ) );
+            OUTPUT_UNITVAL( c, biome+"."+D_DETRITUSC, unitval( c->detritus_c[ i ], U_PGC ) );
+            OUTPUT_UNITVAL( c, biome+"."+D_SOILC, unitval( c->soil_c[ i ], U_PGC ) );
+            OUTPUT_UNITVAL( c, biome+"."+D_TEMPFERTD, unitval( c->tempfertd[ i ], U_UNITLESS ) );
+            OUTPUT_UNITVAL( c, biome+"."+D_TEMPFERTS, unitval( c->tempferts[ i ], U_UNITLESS ) );
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+void OutputCatalogVisitor::visit( HalocarbonComponent* c ) {
+    // TODO: how to get emissions in the gas specific units?
+    if( !core->outputEnabled( c->getComponentName() ) ) return;
+    // Each gas is output under its own component name
+    for( int i = 0; i < c->ngas; ++i ) {
+        const string& name = c->gas_component[ i ];
+        if( !c->enabled[ i ] || !core->outputEnabled( name ) ) continue;
+        if( !subscription.forComponent( name )( D_HC_CONCENTRATION ) ) continue;
+        output( name, D_HC_CONCENTRATION,
+                c->sendMessage( M_GETDATA, name + SNBOX_PARSECHAR + D_HC_CONCENTRATION ) );
+    }
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+void OutputCatalogVisitor::visit( TemperatureComponent* c ) {
+    if( !core->outputEnabled( c->getComponentName() ) ) return;
+    const OutputSubscription::Filter& wanted = subscription.forComponent( c->getComponentName() );
+    if( !wanted.any() ) return;
+    OUTPUT_MESSAGE( c, D_GLOBAL_TEMP );
+    OUTPUT_MESSAGE( c, D_FLUX_MIXED );
+    OUTPUT_MESSAGE( c, D_FLUX_INTERIOR );
+    OUTPUT_MESSAGE( c, D_HEAT_FLUX );
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+void OutputCatalogVisitor::visit( OceanComponent* c ) {
+    if( !core->outputEnabled( c->getComponentName() ) ) return;
+    const OutputSubscription::Filter& wanted = subscription.forComponent( c->getComponentName() );
+    if( !wanted.any() ) return;
+    OUTPUT_MESSAGE( c, D_ATM_OCEAN_FLUX_HL );
+    OUTPUT_MESSAGE( c, D_ATM_OCEAN_FLUX_LL );
+    OUTPUT_MESSAGE( c, D_CARBON_DO );
+    OUTPUT_MESSAGE( c, D_CARBON_HL );
+    OUTPUT_MESSAGE( c, D_CARBON_IO );
+    OUTPUT_MESSAGE( c, D_CARBON_LL );
+    OUTPUT_MESSAGE( c, D_DIC_HL );
+    OUTPUT_MESSAGE( c, D_DIC_LL );
+    OUTPUT_MESSAGE( c, D_HL_DO );
+    OUTPUT_MESSAGE( c, D_OCEAN_CFLUX );
+    OUTPUT_MESSAGE( c, D_OMEGAAR_HL );
+    OUTPUT_MESSAGE( c, D_OMEGAAR_LL );
+    OUTPUT_MESSAGE( c, D_OMEGACA_HL );
+    OUTPUT_MESSAGE( c, D_OMEGACA_LL );
+    OUTPUT_MESSAGE( c, D_PCO2_HL );
+    OUTPUT_MESSAGE( c, D_PCO2_LL );
+    OUTPUT_MESSAGE( c, D_PH_HL );
+    OUTPUT_MESSAGE( c, D_PH_LL );
+    OUTPUT_MESSAGE( c, D_TEMP_HL );
+    OUTPUT_MESSAGE( c, D_TEMP_LL );
+    OUTPUT_MESSAGE( c, D_OCEAN_C );
+    OUTPUT_MESSAGE( c, D_CO3_HL );
+    OUTPUT_MESSAGE( c, D_CO3_LL );
+    OUTPUT_MESSAGE( c, D_TIMESTEPS );
+    if( !in_spinup ) {
+        OUTPUT_MESSAGE( c, D_REVELLE_HL );
+        OUTPUT_MESSAGE( c, D_REVELLE_LL );
+    }
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+void OutputCatalogVisitor::visit( slrComponent* c ) {
+    if( !core->outputEnabled( c->getComponentName() ) ) return;
+    const OutputSubscription::Filter& wanted = subscription.forComponent( c->getComponentName() );
+    if( !wanted.any() ) return;
+    const int refyear = max( c->refperiod_high, c->normalize_year );
+    if( current_date == refyear ) {
+        // Sea level is first known now; output the earlier years
+        for( int i=core->getStartDate()+1; i<current_date; i++ ) {
+            OUTPUT_MESSAGE_EARLIER( c, D_SL_RC, i );
+            OUTPUT_MESSAGE_EARLIER( c, D_SLR, i );
+            OUTPUT_MESSAGE_EARLIER( c, D_SL_RC_NO_ICE, i );
+            OUTPUT_MESSAGE_EARLIER( c, D_SLR_NO_ICE, i );
+        }
+    }
+    if( current_date >= refyear ) {
+        OUTPUT_MESSAGE_DATE( c, D_SL_RC, current_date );
+        OUTPUT_MESSAGE_DATE( c, D_SLR, current_date );
+        OUTPUT_MESSAGE_DATE( c, D_SL_RC_NO_ICE, current_date );
+        OUTPUT_MESSAGE_DATE( c, D_SLR_NO_ICE, current_date );
+    }
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+void OutputCatalogVisitor::visit( OzoneComponent* c ) {
+    if( !core->outputEnabled( c->getComponentName() ) ) return;
+    const OutputSubscription::Filter& wanted = subscription.forComponent( c->getComponentName() );
+    if( !wanted.any() ) return;
+    OUTPUT_MESSAGE_DATE( c, D_ATMOSPHERIC_O3, current_date );
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+void OutputCatalogVisitor::visit( OHComponent* c ) {
+    if( !core->outputEnabled( c->getComponentName() ) ) return;
+    const OutputSubscription::Filter& wanted = subscription.forComponent( c->getComponentName() );
+    if( !wanted.any() ) return;
+    OUTPUT_MESSAGE_DATE( c, D_LIFETIME_OH, current_date );
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+void OutputCatalogVisitor::visit( CH4Component* c ) {
+    if( !core->outputEnabled( c->getComponentName() ) ) return;
+    const OutputSubscription::Filter& wanted = subscription.forComponent( c->getComponentName() );
+    if( !wanted.any() ) return;
+    OUTPUT_MESSAGE_DATE( c, D_ATMOSPHERIC_CH4, current_date );
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+void OutputCatalogVisitor::visit( N2OComponent* c ) {
+    if( !core->outputEnabled( c->getComponentName() ) ) return;
+    const OutputSubscription::Filter& wanted = subscription.forComponent( c->getComponentName() );
+    if( !wanted.any() ) return;
+    OUTPUT_MESSAGE_DATE( c, D_ATMOSPHERIC_N2O, current_date );
+}
+
+}
@@ -0,0 +1,84 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  output_subscription.cpp
+ *  hector
+ *
+ */
+
+#include <boost/algorithm/string.hpp>
+
+#include "output_subscription.hpp"
+
+namespace Hector {
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+/*! \brief Constructor: every variable, until set is called
+ */
+OutputSubscription::OutputSubscription() : is_set( false )
+{
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Set the variables to write
+ *  \param newvars The entries (see class description); empty for everything.
+ */
+void OutputSubscription::set( const vector<string>& newvars ) {
+    vars = newvars;
+    is_set = true;
+    filters.clear();
+}
+
+//------------------------------------------------------------------------------
+/*! \brief The filter for a component's variables
+ *
+ *  Resolved the first time a component asks, then reused.
+ *
+ *  \param component The component name.
+ */
+const OutputSubscription::Filter& OutputSubscription::forComponent( const string& component ) {
+    map<string, Filter>::iterator found = filters.find( component );
+    if( found != filters.end() ) {
+        return found->second;
+    }
+
+    Filter& f = filters[ component ];
+    f.all = vars.empty();
+    const string prefix = component + ".";
+    for( vector<string>::const_iterator it = vars.begin(); it != vars.end() && !f.all; ++it ) {
+        if( *it == component ) {
+            f.all = true;
+        } else if( boost::starts_with( *it, prefix ) ) {
+            f.variables.push_back( it->substr( prefix.size() ) );
+        } else if( it->find( '.' ) == string::npos ) {
+            // may be a variable of any component
+            f.variables.push_back( *it );
+        }
+    }
+    if( f.all ) {
+        f.variables.clear();
+    }
+    return f;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Split a list of entries separated by commas or white space
+ */
+vector<string> OutputSubscription::parse( const string& list ) {
+    vector<string> parts, entries;
+    boost::split( parts, list, boost::is_any_of( ", \t" ), boost::token_compress_on );
+    for( vector<string>::const_iterator it = parts.begin(); it != parts.end(); ++it ) {
+        if( !it->empty() ) {
+            entries.push_back( *it );
+        }
+    }
+    return entries;
+}
+
+}
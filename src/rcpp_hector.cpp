@@ -1,4 +1,5 @@
 #include <Rcpp.h>
+#include <algorithm>
 #include <fstream>
 #include <sstream>
 
@@ -87,6 +88,94 @@ Environment newcore_impl(String inifile, int loglevel, bool suppresslogging, Str
 }
 
 
+//' Write a scenario bundle
+//'
+//' Packs an INI file and all of the input tables it refers to (including land
+//' cell and temperature pattern tables) into a single binary file.  The
+//' bundle can be used in place of the INI file in \code{\link{newcore}}, and
+//' gives the same results; it loads faster and needs no other files, so it
+//' can be moved or copied on its own.
+//'
+//' @param inifile (String) name of the INI file to bundle.
+//' @param bundlefile (String) name of the bundle file to write.
+//' @return The name of the bundle file.
+//' @export
+// [[Rcpp::export]]
+String write_bundle(String inifile, String bundlefile)
+{
+    try {
+        Hector::ScenarioBundle scenario;
+        Hector::INIToCoreReader bundleParser(NULL);
+        bundleParser.record(inifile, scenario);
+        scenario.write(bundlefile);
+    }
+    catch(h_exception e) {
+        std::stringstream msg;
+        msg << "While writing scenario bundle: " << e;
+        Rcpp::stop(msg.str());
+    }
+    return bundlefile;
+}
+
+//' Read Hector binary output
+//'
+//' Reads results from a binary output file, as written by the standalone
+//' model with \code{hector --binary <inifile>}.  Only the requested
+//' variables and dates are read from the file.
+//'
+//' @param filename (String) name of the binary output file.
+//' @param vars Names of the variables to read, either as the variable name
+//' (e.g., \code{"Tgav"}) or as \code{"component.variable"}.  If empty, all
+//' variables are read.
+//' @param startdate First date to read.
+//' @param enddate Last date to read.
+//' @param spinup (bool) If true, read the spinup steps instead of the run.
+//' @return Data frame with columns scenario (the run name), year, component,
+//' variable, value, and units.
+//' @export
+// [[Rcpp::export]]
+DataFrame read_binary_output(String filename, CharacterVector vars = CharacterVector(0),
+                             double startdate = R_NegInf, double enddate = R_PosInf,
+                             bool spinup = false)
+{
+    std::vector<double> year, value;
+    std::vector<std::string> component, variable, units;
+    std::string scenario;
+    try {
+        Hector::BinaryOutputReader reader(filename);
+        scenario = reader.runName();
+        std::vector<std::string> wanted = as<std::vector<std::string> >(vars);
+
+        std::vector<double> d, v;
+        for(size_t i = 0; i < reader.nvariables(); ++i) {
+            const std::string& var = reader.variable(i);
+            const std::string qualified = reader.component(i) + "." + var;
+            if(!wanted.empty() &&
+               std::find(wanted.begin(), wanted.end(), var) == wanted.end() &&
+               std::find(wanted.begin(), wanted.end(), qualified) == wanted.end()) {
+                continue;
+            }
+            reader.read(i, startdate, enddate, d, v, spinup);
+            year.insert(year.end(), d.begin(), d.end());
+            value.insert(value.end(), v.begin(), v.end());
+            component.insert(component.end(), d.size(), reader.component(i));
+            variable.insert(variable.end(), d.size(), var);
+            units.insert(units.end(), d.size(), reader.units(i));
+        }
+    }
+    catch(h_exception e) {
+        std::stringstream msg;
+        msg << "While reading binary output: " << e;
+        Rcpp::stop(msg.str());
+    }
+
+    return DataFrame::create(Named("scenario")=std::vector<std::string>(year.size(), scenario),
+                             Named("year")=year, Named("component")=component,
+                             Named("variable")=variable, Named("value")=value,
+                             Named("units")=units,
+                             Named("stringsAsFactors")=false);
+}
+
 //' Shutdown a hector instance
 //'
 //' Shutting down an instance will free the instance itself and all of the objects it created. Any attempted
@@ -250,6 +339,74 @@ Environment rename_biome(Environment core, std::string oldname, std::string newn
     return core;
 }
 
+//' Store variables for every year as a Hector instance runs
+//'
+//' The variables are stored in the Hector instance, in contiguous arrays, as
+//' each year of the run finishes.  Retrieve them with
+//' \code{\link{fetch_results}}, which is much faster than
+//' \code{\link{fetchvars}} for many variables or long runs.  Calling this
+//' again replaces the variable list and discards stored results.  Results
+//' for years after a date the instance is \code{\link{reset}} to are
+//' discarded.
+//'
+//' @param core Handle to a Hector instance
+//' @param vars Capability strings of the variables to store
+//' @return The Hector instance handle
+//' @export
+// [[Rcpp::export]]
+Environment collect_results(Environment core, std::vector<std::string> vars)
+{
+    Hector::Core *hcore = gethcore(core);
+    try {
+        hcore->collectResults(vars);
+    }
+    catch(h_exception e) {
+        std::stringstream msg;
+        msg << "collect_results: " << e;
+        Rcpp::stop(msg.str());
+    }
+    return core;
+}
+
+//' Fetch the results stored by collect_results
+//'
+//' @param core Handle to a Hector instance
+//' @return Data frame with columns scenario, year, variable, value, and
+//' units, for every year run so far and every variable given to
+//' \code{\link{collect_results}}.
+//' @export
+// [[Rcpp::export]]
+DataFrame fetch_results(Environment core)
+{
+    Hector::Core *hcore = gethcore(core);
+    const Hector::ResultsCollectorVisitor *results = hcore->getResults();
+    if(!results) {
+        Rcpp::stop("fetch_results: collect_results has not been called for this core");
+    }
+
+    const size_t nyear = results->nyears();
+    const size_t nvar = results->nvariables();
+    NumericVector year(nyear * nvar), value(nyear * nvar);
+    CharacterVector variable(nyear * nvar), units(nyear * nvar);
+    for(size_t i = 0; i < nvar; ++i) {
+        // each column is contiguous
+        if(nyear > 0) {
+            std::copy(results->column(i), results->column(i) + nyear, value.begin() + i * nyear);
+        }
+        for(size_t j = 0; j < nyear; ++j) {
+            year[i * nyear + j] = results->firstDate() + j;
+            variable[i * nyear + j] = results->variable(i);
+            units[i * nyear + j] = results->units(i);
+        }
+    }
+
+    String scenario = core["name"];
+    return DataFrame::create(Named("scenario")=CharacterVector(nyear * nvar, scenario),
+                             Named("year")=year, Named("variable")=variable,
+                             Named("value")=value, Named("units")=units,
+                             Named("stringsAsFactors")=false);
+}
+
 
 //' Send a message to a Hector instance
 //'
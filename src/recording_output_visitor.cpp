@@ -0,0 +1,120 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  recording_output_visitor.cpp
+ *  hector
+ *
+ */
+
+#include <limits>
+
+#include "core.hpp"
+#include "recording_output_visitor.hpp"
+
+namespace Hector {
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+/*! \brief Constructor
+ *  \param fileName The file the results will be written to.
+ */
+RecordingOutputVisitor::RecordingOutputVisitor( const string& fileName )
+:fileName( fileName ), closed( false )
+{
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Destructor
+ *
+ *  Nothing is written unless close was called.
+ */
+RecordingOutputVisitor::~RecordingOutputVisitor() {
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+bool RecordingOutputVisitor::shouldVisit( const bool is, const double date ) {
+    if( closed ) return false;
+    OutputCatalogVisitor::shouldVisit( is, date );
+
+    // every model period gets a record
+    dates.push_back( date );
+    spinup.push_back( is );
+    records.push_back( vector<double>() );
+    records.back().reserve( components.size() );
+    return true;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Record a value for the current period
+ */
+void RecordingOutputVisitor::output( const string& component, const string& name, const unitval& x ) {
+    H_ASSERT( !records.empty(), "no current record" );
+    record( records.size() - 1, component, name, x );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Record a value for the latest non-spinup period with the given date
+ */
+void RecordingOutputVisitor::output( const string& component, const string& name, const unitval& x,
+                                     double date ) {
+    size_t r = records.size();
+    while( r > 0 && ( spinup[ r - 1 ] || dates[ r - 1 ] != date ) ) {
+        --r;
+    }
+    if( r > 0 ) {               // otherwise the date was not visited
+        record( r - 1, component, name, x );
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Record a value in the given record
+ *
+ *  Variables not seen before are added to the end of the dictionary.  A
+ *  variable's units are the last defined units it was recorded with.
+ */
+void RecordingOutputVisitor::record( size_t r, const string& component, const string& name,
+                                     const unitval& x ) {
+    const pair<string, string> key( component, name );
+    map<pair<string, string>, size_t>::const_iterator found = index.find( key );
+    size_t i;
+    if( found == index.end() ) {
+        i = components.size();
+        index[ key ] = i;
+        components.push_back( component );
+        names.push_back( name );
+        units.push_back( x.unitsName() );
+    } else {
+        i = found->second;
+        // some values have no units during spinup
+        if( x.units() != U_UNDEFINED ) {
+            units[ i ] = x.unitsName();
+        }
+    }
+
+    vector<double>& rec = records[ r ];
+    if( rec.size() <= i ) {
+        rec.resize( i + 1, numeric_limits<double>::quiet_NaN() );
+    }
+    rec[ i ] = x.value( x.units() );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Write the recorded results to the file
+ *
+ *  Only the first call writes; the visitor records nothing afterwards.
+ *
+ *  \exception h_exception If the file could not be written.
+ */
+void RecordingOutputVisitor::close() {
+    if( closed ) return;
+    closed = true;
+    write();
+}
+
+}
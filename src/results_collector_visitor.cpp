@@ -0,0 +1,126 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  results_collector_visitor.cpp
+ *  hector
+ *
+ */
+
+#include <algorithm>
+#include <limits>
+
+#include "results_collector_visitor.hpp"
+#include "core.hpp"
+#include "imodel_component.hpp"
+#include "message_data.hpp"
+#include "simpleNbox.hpp"
+
+namespace Hector {
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+/*! \brief Constructor
+ *
+ *  \param core The core the variables come from; it must have been set up
+ *              (its start and end dates are used to size the columns).
+ *  \param vars The variables to store.
+ *  \exception h_exception If a variable is not a capability of any component.
+ */
+ResultsCollectorVisitor::ResultsCollectorVisitor( Core* core, const vector<string>& vars )
+: vars( vars ), var_units( vars.size() ), capacity( 0 ), nrows( 0 ),
+  first_date( core->getStartDate() + 1 ), current_date( 0 )
+{
+    for( vector<string>::const_iterator it = vars.begin(); it != vars.end(); ++it ) {
+        // biome-specific variables are <biome>.<capability>
+        const size_t sep = it->find( SNBOX_PARSECHAR );
+        const string capability = sep == string::npos ? *it : it->substr( sep + 1 );
+        components.push_back( core->getComponentByCapability( capability ) );
+    }
+    reserve( static_cast<size_t>( max( core->getEndDate() - first_date + 1, 0.0 ) ) );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Destructor
+ */
+ResultsCollectorVisitor::~ResultsCollectorVisitor() {
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+bool ResultsCollectorVisitor::shouldVisit( const bool in_spinup, const double date ) {
+    current_date = date;
+    return !in_spinup && date >= first_date;
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+void ResultsCollectorVisitor::visit( Core* c ) {
+    const size_t row = static_cast<size_t>( current_date - first_date );
+    if( row >= capacity ) {
+        // running past the end date
+        reserve( max( row + 1, 2 * capacity ) );
+    }
+
+    const message_data info( current_date );
+    for( size_t i = 0; i < vars.size(); ++i ) {
+        const unitval x = components[ i ]->sendMessage( M_GETDATA, vars[ i ], info );
+        data[ i * capacity + row ] = x.value( x.units() );
+        if( x.units() != U_UNDEFINED ) {
+            var_units[ i ] = x.unitsName();
+        }
+    }
+    nrows = row + 1;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Forget the years after a date the core has been reset to
+ */
+void ResultsCollectorVisitor::reset( double date ) {
+    const size_t keep = date < first_date ? 0 : static_cast<size_t>( date - first_date + 1 );
+    nrows = min( nrows, keep );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Find a variable
+ *
+ *  \param var The variable, as given when the collector was created.
+ *  \return Its position in the store.
+ *  \exception h_exception If the variable is not stored.
+ */
+size_t ResultsCollectorVisitor::findVariable( const string& var ) const {
+    vector<string>::const_iterator it = find( vars.begin(), vars.end(), var );
+    H_ASSERT( it != vars.end(), "variable not collected: " + var );
+    return it - vars.begin();
+}
+
+//------------------------------------------------------------------------------
+/*! \brief The values of a variable, one for each of the nyears() years from
+ *         firstDate().
+ *
+ *  The pointer is valid until the next visit.
+ */
+const double* ResultsCollectorVisitor::column( size_t i ) const {
+    H_ASSERT( i < vars.size(), "variable index out of range" );
+    return data.empty() ? 0 : &data[ i * capacity ];
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Make room for at least n rows in every column
+ */
+void ResultsCollectorVisitor::reserve( size_t n ) {
+    if( n <= capacity ) return;
+    vector<double> newdata( vars.size() * n, numeric_limits<double>::quiet_NaN() );
+    for( size_t i = 0; i < vars.size(); ++i ) {
+        copy( data.begin() + i * capacity, data.begin() + i * capacity + nrows,
+              newdata.begin() + i * n );
+    }
+    data.swap( newdata );
+    capacity = n;
+}
+
+}
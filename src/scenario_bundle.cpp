@@ -0,0 +1,234 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  scenario_bundle.cpp
+ *  hector
+ *
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdint.h>
+
+#include "binary_io.hpp"
+#include "core.hpp"
+#include "message_data.hpp"
+#include "scenario_bundle.hpp"
+#include "unitval.hpp"
+
+namespace Hector {
+
+using namespace std;
+
+const unsigned int ScenarioBundle::version;
+
+//! First bytes of every bundle
+static const char bundle_magic[] = "HECTORSB";
+
+//------------------------------------------------------------------------------
+/*! \brief Add a value set by the INI file
+ *
+ *  \param section The INI section (component name)
+ *  \param name The variable name
+ *  \param value The value, as given in the file
+ *  \param date The date the value is for, or Core::undefinedIndex()
+ */
+void ScenarioBundle::addValue( const string& section, const string& name,
+                               const string& value, double date )
+{
+    entry e;
+    e.kind = VALUE;
+    e.section = section;
+    e.name = name;
+    e.value = value;
+    e.date = date;
+    entries.push_back( e );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Add a table that a component reads itself
+ *
+ *  The whole file is read now and kept in the bundle.
+ *
+ *  \param section The INI section (component name)
+ *  \param name The variable name
+ *  \param fileName The table's file name
+ *  \exception h_exception If the file could not be read.
+ */
+void ScenarioBundle::addFile( const string& section, const string& name,
+                              const string& fileName )
+{
+    ifstream in( fileName.c_str(), ios::in | ios::binary );
+    if( !in ) {
+        H_THROW( "Could not open " + fileName + " error: " + strerror( errno ) );
+    }
+    ostringstream contents;
+    contents << in.rdbuf();
+    H_ASSERT( in, "Could not read " + fileName );
+
+    entry e;
+    e.kind = FILE;
+    e.section = section;
+    e.name = name;
+    e.value = fileName;
+    e.date = Core::undefinedIndex();
+    e.contents = make_shared<const string>( contents.str() );
+    entries.push_back( e );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Add a time series read from a table
+ *
+ *  \param section The INI section (component name)
+ *  \param name The variable name
+ *  \param units The units label for all values (empty for none)
+ *  \param dates Dates of the values
+ *  \param values The values
+ */
+void ScenarioBundle::addSeries( const string& section, const string& name,
+                                const string& units, const vector<double>& dates,
+                                const vector<double>& values )
+{
+    H_ASSERT( dates.size() == values.size(), "dates and values must be the same length" );
+    entry e;
+    e.kind = SERIES;
+    e.section = section;
+    e.name = name;
+    e.date = Core::undefinedIndex();
+    e.units = units;
+    e.dates = dates;
+    e.values = values;
+    entries.push_back( e );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Write the bundle to a file
+ *
+ *  \param fileName The file to write.
+ *  \exception h_exception If the file could not be written.
+ */
+void ScenarioBundle::write( const string& fileName ) const {
+    BinaryWriter buf( bundle_magic, version );
+    buf.put_u32( static_cast<uint32_t>( entries.size() ) );
+    for( vector<entry>::const_iterator e = entries.begin(); e != entries.end(); ++e ) {
+        buf.put_u8( static_cast<uint8_t>( e->kind ) );
+        buf.put_string( e->section );
+        buf.put_string( e->name );
+        if( e->kind == VALUE ) {
+            buf.put_double( e->date );
+            buf.put_string( e->value );
+        } else if( e->kind == FILE ) {
+            buf.put_string( e->value );
+            buf.put_string( *e->contents );
+        } else {
+            buf.put_string( e->units );
+            buf.put_u32( static_cast<uint32_t>( e->dates.size() ) );
+            buf.put_doubles( e->dates );
+            buf.put_doubles( e->values );
+        }
+    }
+
+    ofstream out( fileName.c_str(), ios::out | ios::binary | ios::trunc );
+    out.write( buf.data().data(), buf.data().size() );
+    out.close();
+    if( !out ) {
+        H_THROW( "Could not write scenario bundle " + fileName + " error: " + strerror( errno ) );
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Read a bundle from a file, replacing any entries
+ *
+ *  \param fileName The file to read.
+ *  \exception h_exception If the file could not be read, is not a bundle, or
+ *                         was written by another version or platform.
+ */
+void ScenarioBundle::read( const string& fileName ) {
+    ifstream in( fileName.c_str(), ios::in | ios::binary );
+    if( !in ) {
+        H_THROW( "Could not open scenario bundle " + fileName + " error: " + strerror( errno ) );
+    }
+    in.seekg( 0, ios::end );
+    const streamoff size = in.tellg();
+    in.seekg( 0, ios::beg );
+
+    BinaryReader cur( in, size, fileName, "scenario bundle" );
+    cur.read_header( bundle_magic, version );
+
+    const uint32_t n = cur.get_u32();
+    vector<entry> newentries;
+    for( uint32_t i = 0; i < n; ++i ) {
+        newentries.push_back( entry() );
+        entry& e = newentries.back();
+        const uint8_t kind = cur.get_u8();
+        H_ASSERT( kind == VALUE || kind == SERIES || kind == FILE,
+                  "Scenario bundle " + fileName + " is corrupt" );
+        e.kind = static_cast<entry_kind>( kind );
+        e.section = cur.get_string();
+        e.name = cur.get_string();
+        if( e.kind == VALUE ) {
+            e.date = cur.get_double();
+            e.value = cur.get_string();
+        } else if( e.kind == FILE ) {
+            e.date = Core::undefinedIndex();
+            e.value = cur.get_string();
+            e.contents = make_shared<const string>( cur.get_string() );
+        } else {
+            e.date = Core::undefinedIndex();
+            e.units = cur.get_string();
+            const uint32_t len = cur.get_u32();
+            cur.get_doubles( e.dates, len );
+            cur.get_doubles( e.values, len );
+        }
+    }
+    H_ASSERT( cur.left() == 0, "Scenario bundle " + fileName + " has trailing data" );
+    entries.swap( newentries );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Route the bundle's values through the core.
+ *
+ *  Values are sent as strings, as parsing the INI file would; series values
+ *  are sent as unitvals, as CSVTableReader would.  Files are sent as their
+ *  name with their contents.
+ *
+ *  \param core The core to set data in.
+ *  \exception h_exception Any errors generated by the core while trying to setData.
+ */
+void ScenarioBundle::apply( Core* core ) const {
+    for( vector<entry>::const_iterator e = entries.begin(); e != entries.end(); ++e ) {
+        if( e->kind == VALUE ) {
+            message_data data( e->value );
+            data.date = e->date;
+            core->setData( e->section, e->name, data );
+        } else if( e->kind == FILE ) {
+            message_data data( e->value );
+            data.file_contents = e->contents;
+            core->setData( e->section, e->name, data );
+        } else {
+            // no units means the component's expected units
+            const unit_types units = e->units.empty() ? U_UNDEFINED : unitval::parseUnitsName( e->units );
+            for( size_t i = 0; i < e->dates.size(); ++i ) {
+                core->setData( e->section, e->name,
+                               message_data( e->dates[ i ], unitval( e->values[ i ], units ) ) );
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Whether a file is a scenario bundle (rather than an INI file)
+ *
+ *  \param fileName The file to check.
+ */
+bool ScenarioBundle::isBundle( const string& fileName ) {
+    return BinaryReader::has_magic( fileName, bundle_magic );
+}
+
+}
@@ -13,12 +13,15 @@
  */
 
 #include "boost/algorithm/string.hpp"
+#include "boost/lexical_cast.hpp"
 
 #include "dependency_finder.hpp"
 #include "simpleNbox.hpp"
 #include "avisitor.hpp"
+#include "csv_table_reader.hpp"
 
 #include <algorithm>
+#include <numeric>
 
 namespace Hector {
 
@@ -27,7 +30,7 @@ using namespace boost;
 //------------------------------------------------------------------------------
 /*! \brief constructor
  */
-SimpleNbox::SimpleNbox() : CarbonCycleModel( 6 ), masstot(0.0) {
+SimpleNbox::SimpleNbox() : CarbonCycleModel( SNBOX_NGLOBAL ), nslots(0), history_writes(0), masstot(0.0) {
     ffiEmissions.allowInterp( true );
     ffiEmissions.name = "ffiEmissions";
     lucEmissions.allowInterp( true );
@@ -49,16 +52,17 @@ void SimpleNbox::init( Core* coreptr ) {
     core = coreptr;
 
     // Defaults
-    co2fert[ SNBOX_DEFAULT_BIOME ] = 1.0;
-    warmingfactor[ SNBOX_DEFAULT_BIOME ] = 1.0;
     residual.set( 0.0, U_PGC );
-    tempfertd[ SNBOX_DEFAULT_BIOME ] = 1.0;
-    tempferts[ SNBOX_DEFAULT_BIOME ] = 1.0;
 
     // Initialize the `biome_list` with just "global"
-    biome_list.push_back( SNBOX_DEFAULT_BIOME );
+    add_biome_data( SNBOX_DEFAULT_BIOME );
+    warmingfactor[ 0 ] = 1.0;
 
     Tgav_record.allowInterp( true );
+    Tgav_window.assign( Q10_TEMPN, 0.0 );
+    Tgav_window_sum = 0.0;
+    Tgav_window_t = Core::undefinedIndex();
+    cycle_skipped = false;
 
     // Register the data we can provide
     core->registerCapability( D_ATMOSPHERIC_CO2, getComponentName() );
@@ -130,27 +134,18 @@ void SimpleNbox::setData( const std::string &varName,
 
     std::string biome = SNBOX_DEFAULT_BIOME;
     std::string varNameParsed = varName;
-    auto it_global = std::find(biome_list.begin(), biome_list.end(), SNBOX_DEFAULT_BIOME);
+    int i_global = biome_index( SNBOX_DEFAULT_BIOME );
 
     if( splitvec.size() == 2 ) {    // i.e., in form <biome>.<varname>
         biome = splitvec[ 0 ];
         varNameParsed = splitvec[ 1 ];
-        if ( has_biome( SNBOX_DEFAULT_BIOME ) ) {
-            H_LOG( logger, Logger::DEBUG ) << "Removing biome '" << SNBOX_DEFAULT_BIOME <<
-                "' because you cannot have both 'global' and biome data. " << std::endl;
-            // We don't use the `deleteBiome` function here because
-            // when `setData` is used to initialize the core from the
-            // INI file, most of the time series variables that
-            // `deleteBiome` modifies have not been initialized yet.
-            // This should be relatively safe because (1) we check
-            // consistency of biome-specific variable sizes before
-            // running, and (2) the R interface will not let you use
-            // `setData` to modify the biome list.
-            biome_list.erase( it_global );
+        if ( i_global >= 0 && biome != SNBOX_DEFAULT_BIOME ) {
+            drop_global_biome();
+            i_global = -1;
         }
     }
 
-    H_ASSERT( !(it_global != biome_list.end() && biome != SNBOX_DEFAULT_BIOME),
+    H_ASSERT( !(i_global >= 0 && biome != SNBOX_DEFAULT_BIOME),
               "If one of the biomes is 'global', you cannot add other biomes." );
 
     // If the biome is not currently in the `biome_list`, and it's not
@@ -158,8 +153,9 @@ void SimpleNbox::setData( const std::string &varName,
     if ( biome != SNBOX_DEFAULT_BIOME && !has_biome( biome ) ) {
         H_LOG( logger, Logger::DEBUG ) << "Adding biome '" << biome << "' to `biome_list`." << std::endl;
         // We don't use `createBiome` here for the same reasons as above.
-        biome_list.push_back( biome );
+        add_biome_data( biome );
     }
+    const int i_biome = biome_index( biome );
 
     if (data.isVal) {
         H_LOG( logger, Logger::DEBUG ) << "Setting " << biome << "." << varNameParsed << "[" << data.date << "]=" << data.value_unitval << std::endl;
@@ -168,6 +164,17 @@ void SimpleNbox::setData( const std::string &varName,
         H_LOG( logger, Logger::DEBUG ) << "Setting " << biome << "." << varNameParsed << "[" << data.date << "]=" << data.value_str << std::endl;
     }
     try {
+        // Biome-specific data for the global biome after it has been
+        // replaced by named biomes has nowhere to go
+        if( i_biome < 0 ) {
+            H_ASSERT( varNameParsed != D_VEGC && varNameParsed != D_DETRITUSC &&
+                      varNameParsed != D_SOILC && varNameParsed != D_NPP_FLUX0 &&
+                      varNameParsed != D_F_NPPV && varNameParsed != D_F_NPPD &&
+                      varNameParsed != D_F_LITTERD && varNameParsed != D_BETA &&
+                      varNameParsed != D_WARMINGFACTOR && varNameParsed != D_Q10_RH,
+                      "Biome '" + biome + "' missing from biome list" );
+        }
+
         // Initial pools
         if( varNameParsed == D_ATMOSPHERIC_C ) {
             // Hector input files specify initial atmospheric CO2 in terms of
@@ -193,24 +200,30 @@ void SimpleNbox::setData( const std::string &varName,
             // interactive use, you will usually want to pass the date
             // -- otherwise, the current value will be overridden by a
             // `reset` (which includes code like `veg_c = veg_c_tv.get(t)`).
-            veg_c[ biome ] = data.getUnitval( U_PGC );
+            veg_c[ i_biome ] = data.getUnitval( U_PGC ).value( U_PGC );
             if (data.date != Core::undefinedIndex()) {
-                veg_c_tv.set(data.date, veg_c);
+                veg_c_tv.set(data.date, history_row( veg_c ));
             }
         }
         else if( varNameParsed == D_DETRITUSC ) {
-            detritus_c[ biome ] = data.getUnitval( U_PGC );
+            detritus_c[ i_biome ] = data.getUnitval( U_PGC ).value( U_PGC );
             if (data.date != Core::undefinedIndex()) {
-                detritus_c_tv.set(data.date, detritus_c);
+                detritus_c_tv.set(data.date, history_row( detritus_c ));
             }
         }
         else if( varNameParsed == D_SOILC ) {
-            soil_c[ biome ] = data.getUnitval( U_PGC );
+            soil_c[ i_biome ] = data.getUnitval( U_PGC ).value( U_PGC );
             if (data.date != Core::undefinedIndex()) {
-                soil_c_tv.set(data.date, soil_c);
+                soil_c_tv.set(data.date, history_row( soil_c ));
             }
         }
 
+        else if( varNameParsed == D_LAND_CELLS ) {
+            H_ASSERT( data.date == Core::undefinedIndex(), "date not allowed" );
+            H_ASSERT( biome == SNBOX_DEFAULT_BIOME, "land cell table must be global" );
+            read_cell_table( data.value_str, data.file_contents );
+        }
+
         // Albedo effect
         else if( varNameParsed == D_RF_T_ALBEDO ) {
             H_ASSERT( data.date != Core::undefinedIndex(), "date required" );
@@ -220,15 +233,15 @@ void SimpleNbox::setData( const std::string &varName,
         // Partitioning
         else if( varNameParsed == D_F_NPPV ) {
             H_ASSERT( data.date == Core::undefinedIndex() , "date not allowed" );
-            f_nppv[ biome ] = data.getUnitval(U_UNITLESS);
+            f_nppv[ i_biome ] = data.getUnitval(U_UNITLESS);
         }
         else if( varNameParsed == D_F_NPPD ) {
             H_ASSERT( data.date == Core::undefinedIndex() , "date not allowed" );
-            f_nppd[ biome ] = data.getUnitval(U_UNITLESS);
+            f_nppd[ i_biome ] = data.getUnitval(U_UNITLESS);
         }
         else if( varNameParsed == D_F_LITTERD ) {
             H_ASSERT( data.date == Core::undefinedIndex() , "date not allowed" );
-            f_litterd[ biome ] = data.getUnitval(U_UNITLESS);
+            f_litterd[ i_biome ] = data.getUnitval(U_UNITLESS);
         }
         else if( varNameParsed == D_F_LUCV ) {
             H_ASSERT( data.date == Core::undefinedIndex() , "date not allowed" );
@@ -242,7 +255,7 @@ void SimpleNbox::setData( const std::string &varName,
         // Initial fluxes
         else if( varNameParsed == D_NPP_FLUX0 ) {
             H_ASSERT( data.date == Core::undefinedIndex() , "date not allowed" );
-            npp_flux0[ biome ] = data.getUnitval( U_PGC_YR );
+            npp_flux0[ i_biome ] = data.getUnitval( U_PGC_YR ).value( U_PGC_YR );
         }
 
         // Fossil fuels and industry contributions--time series.  There are two
@@ -268,15 +281,15 @@ void SimpleNbox::setData( const std::string &varName,
         // Fertilization
         else if( varNameParsed == D_BETA ) {
             H_ASSERT( data.date == Core::undefinedIndex() , "date not allowed" );
-            beta[ biome ] = data.getUnitval(U_UNITLESS);
+            beta[ i_biome ] = data.getUnitval(U_UNITLESS);
         }
         else if( varNameParsed == D_WARMINGFACTOR ) {
             H_ASSERT( data.date == Core::undefinedIndex() , "date not allowed" );
-            warmingfactor[ biome ] = data.getUnitval(U_UNITLESS);
+            warmingfactor[ i_biome ] = data.getUnitval(U_UNITLESS);
         }
         else if( varNameParsed == D_Q10_RH ) {
             H_ASSERT( data.date == Core::undefinedIndex() , "date not allowed" );
-            q10_rh[ biome ] = data.getUnitval(U_UNITLESS);
+            q10_rh[ i_biome ] = data.getUnitval(U_UNITLESS);
         }
 
         else {
@@ -302,17 +315,16 @@ void SimpleNbox::sanitychecks()
     // Make a few sanity checks here, and then return.
     H_ASSERT( atmos_c.value( U_PGC ) > 0.0, "atmos_c pool <=0" );
 
-    for ( auto it = biome_list.begin(); it != biome_list.end(); it++ ) {
-        std::string biome = *it;
-        H_ASSERT( veg_c.at(biome).value( U_PGC ) >= 0.0, "veg_c pool < 0" );
-        H_ASSERT( detritus_c.at(biome).value( U_PGC ) >= 0.0, "detritus_c pool < 0" );
-        H_ASSERT( soil_c.at(biome).value( U_PGC ) >= 0.0, "soil_c pool < 0" );
-        H_ASSERT( npp_flux0.at(biome).value( U_PGC_YR ) >= 0.0, "npp_flux0 < 0" );
-
-        H_ASSERT( f_nppv.at(biome) >= 0.0, "f_nppv <0" );
-        H_ASSERT( f_nppd.at(biome) >= 0.0, "f_nppd <0" );
-        H_ASSERT( f_nppv.at(biome) + f_nppd.at(biome) <= 1.0, "f_nppv + f_nppd >1" );
-        H_ASSERT( f_litterd.at(biome) >= 0.0 && f_litterd.at(biome) <= 1.0, "f_litterd <0 or >1" );
+    for ( int i = 0; i < nbiomes(); i++ ) {
+        H_ASSERT( veg_c[ i ] >= 0.0, "veg_c pool < 0" );
+        H_ASSERT( detritus_c[ i ] >= 0.0, "detritus_c pool < 0" );
+        H_ASSERT( soil_c[ i ] >= 0.0, "soil_c pool < 0" );
+        H_ASSERT( npp_flux0[ i ] >= 0.0, "npp_flux0 < 0" );
+
+        H_ASSERT( f_nppv[ i ] >= 0.0, "f_nppv <0" );
+        H_ASSERT( f_nppd[ i ] >= 0.0, "f_nppd <0" );
+        H_ASSERT( f_nppv[ i ] + f_nppd[ i ] <= 1.0, "f_nppv + f_nppd >1" );
+        H_ASSERT( f_litterd[ i ] >= 0.0 && f_litterd[ i ] <= 1.0, "f_litterd <0 or >1" );
     }
 
     H_ASSERT( f_lucv >= 0.0, "f_lucv <0" );
@@ -324,32 +336,17 @@ void SimpleNbox::sanitychecks()
 }
 
 //------------------------------------------------------------------------------
-/*! \brief      Sum a string->unitval map
+/*! \brief      Sum a biome array
  *  \param      pool to sum over
- *  \returns    Sum of the unitvals in the map
- *  \exception  If the map is empty
+ *  \returns    Sum of the values in the array
+ *  \exception  If the array is empty
  */
-unitval SimpleNbox::sum_map( unitval_stringmap pool ) const
+double SimpleNbox::sum_vector( const double_vector& pool ) const
 {
-    H_ASSERT( pool.size(), "can't sum an empty map" );
-    unitval sum( 0.0, pool.begin()->second.units() );
-    for( unitval_stringmap::const_iterator it = pool.begin(); it != pool.end(); it++ )
-        sum = sum + it->second;
-    return sum;
-}
-
-//------------------------------------------------------------------------------
-/*! \brief      Sum a string->double map
- *  \param      pool to sum over
- *  \returns    Sum of the unitvals in the map
- *  \exception  If the map is empty
- */
-double SimpleNbox::sum_map( double_stringmap pool ) const
-{
-    H_ASSERT( pool.size(), "can't sum an empty map" );
+    H_ASSERT( pool.size(), "can't sum an empty biome array" );
     double sum = 0.0;
-    for( double_stringmap::const_iterator it = pool.begin(); it != pool.end(); it++ )
-        sum = sum + it->second;
+    for( double_vector::const_iterator it = pool.begin(); it != pool.end(); it++ )
+        sum = sum + *it;
     return sum;
 }
 
@@ -363,10 +360,9 @@ void SimpleNbox::log_pools( const double t )
     H_LOG( logger,Logger::DEBUG ) << "---- simpleNbox pool states at t=" << t << " ----" << std::endl;
     H_LOG( logger,Logger::DEBUG ) << "Atmos = " << atmos_c << std::endl;
     H_LOG( logger,Logger::DEBUG ) << "Biome \tveg_c \t\tdetritus_c \tsoil_c" << std::endl;
-    for ( auto it = biome_list.begin(); it != biome_list.end(); it++ ) {
-        std::string biome = *it;
-        H_LOG( logger,Logger::DEBUG ) << biome << "\t" << veg_c[ biome ] << "\t" <<
-        detritus_c[ biome ] << "\t\t" << soil_c[ biome ] << std::endl;
+    for ( int i = 0; i < nbiomes(); i++ ) {
+        H_LOG( logger,Logger::DEBUG ) << biome_list[ i ] << "\t" << veg_c[ i ] << "\t" <<
+        detritus_c[ i ] << "\t\t" << soil_c[ i ] << std::endl;
     }
     H_LOG( logger,Logger::DEBUG ) << "Earth = " << earth_c << std::endl;
 }
@@ -384,25 +380,26 @@ void SimpleNbox::prepareToRun()
                  "Did you forget to rename the default ('global') biome?")
     }
 
-    // Ensure consistency between biome_list and all pools and fluxes
-    H_ASSERT( biome_list.size() == veg_c.size(), "veg_c and biome_list data not same size" );
-    H_ASSERT( biome_list.size() == detritus_c.size(), "detritus_c and biome_list not same size" );
-    H_ASSERT( biome_list.size() == soil_c.size(), "soil_c and biome_list not same size" );
-    H_ASSERT( biome_list.size() == npp_flux0.size(), "npp_flux0 and biome_list not same size" );
-
-    for ( auto it = biome_list.begin(); it != biome_list.end(); it++ ) {
-        std::string biome = *it;
-        H_LOG( logger, Logger::DEBUG ) << "Checking that data for biome '" << biome << "' is complete" << std::endl;
-        H_ASSERT( detritus_c.count( biome ), "no biome data for detritus_c" );
-        H_ASSERT( soil_c.count( biome ), "no biome data for soil_c" );
-        H_ASSERT( npp_flux0.count( biome ), "no biome data for npp_flux0" );
-
-        H_ASSERT( beta.count( biome ), "no biome value for beta" );
-
-        if ( !warmingfactor.count( biome )) {
-            H_LOG( logger, Logger::NOTICE ) << "No warmingfactor set for biome '" << biome << "'. " <<
+    // Ensure consistency between biome_list and all pools and fluxes.
+    // Pools and parameters that were never set for a biome are missing.
+    H_ASSERT( nbiomes() > 0, "biome_list is empty" );
+    for ( int i = 0; i < nbiomes(); i++ ) {
+        H_LOG( logger, Logger::DEBUG ) << "Checking that data for biome '" << biome_list[ i ] << "' is complete" << std::endl;
+        H_ASSERT( !std::isnan( veg_c[ i ] ), "veg_c and biome_list data not same size" );
+        H_ASSERT( !std::isnan( detritus_c[ i ] ), "detritus_c and biome_list not same size" );
+        H_ASSERT( !std::isnan( soil_c[ i ] ), "soil_c and biome_list not same size" );
+        H_ASSERT( !std::isnan( npp_flux0[ i ] ), "npp_flux0 and biome_list not same size" );
+
+        H_ASSERT( !std::isnan( beta[ i ] ), "no biome value for beta" );
+        H_ASSERT( !std::isnan( q10_rh[ i ] ), "no biome value for q10_rh" );
+        H_ASSERT( !std::isnan( f_nppv[ i ] ), "no biome value for f_nppv" );
+        H_ASSERT( !std::isnan( f_nppd[ i ] ), "no biome value for f_nppd" );
+        H_ASSERT( !std::isnan( f_litterd[ i ] ), "no biome value for f_litterd" );
+
+        if ( std::isnan( warmingfactor[ i ] ) ) {
+            H_LOG( logger, Logger::NOTICE ) << "No warmingfactor set for biome '" << biome_list[ i ] << "'. " <<
                 "Setting to default value = 1.0" << std::endl;
-            warmingfactor[ biome ] = 1.0;
+            warmingfactor[ i ] = 1.0;
         }
 
     }
@@ -426,9 +423,9 @@ void SimpleNbox::prepareToRun()
     }
 
     // One-time checks
-    for( auto it = biome_list.begin(); it != biome_list.end(); it++ ) {
-        H_ASSERT( beta.at( *it ) >= 0.0, "beta < 0" );
-        H_ASSERT( q10_rh.at( *it )>0.0, "q10_rh <= 0.0" );
+    for( int i = 0; i < nbiomes(); i++ ) {
+        H_ASSERT( beta[ i ] >= 0.0, "beta < 0" );
+        H_ASSERT( q10_rh[ i ]>0.0, "q10_rh <= 0.0" );
     }
     sanitychecks();
 }
@@ -443,6 +440,7 @@ void SimpleNbox::prepareToRun()
 void SimpleNbox::run( const double runToDate )
 {
     in_spinup = core->inSpinup();
+    cycle_skipped = !in_spinup && core->concentrationDriven() && atmosphere_prescribed( runToDate );
     sanitychecks();
 
     Tgav_record.set( runToDate, core->sendMessage( M_GETDATA, D_GLOBAL_TEMP ).value( U_DEGC ) );
@@ -459,6 +457,7 @@ bool SimpleNbox::run_spinup( const int step )
 {
     sanitychecks();
     in_spinup = true;
+    cycle_skipped = false;
     return true;        // solver will really be the one signalling
 }
 
@@ -486,6 +485,7 @@ unitval SimpleNbox::getData(const std::string& varName,
         biome_error = "Biome '" + biome + "' missing from biome list. " +
             "Hit this error while trying to retrieve variable: '" + varName + "'.";
     }
+    const int i_biome = biome_index( biome );
 
     if( varNameParsed == D_ATMOSPHERIC_C ) {
         if(date == Core::undefinedIndex())
@@ -507,15 +507,16 @@ unitval SimpleNbox::getData(const std::string& varName,
         returnval = C0;
     } else if(varNameParsed == D_WARMINGFACTOR) {
         H_ASSERT(date == Core::undefinedIndex(), "Date not allowed for biome warming factor");
-        H_ASSERT(has_biome( biome ), biome_error);
-        returnval = unitval(warmingfactor.at(biome), U_UNITLESS);
+        H_ASSERT(i_biome >= 0, biome_error);
+        returnval = unitval(warmingfactor[ i_biome ], U_UNITLESS);
     } else if(varNameParsed == D_BETA) {
         H_ASSERT(date == Core::undefinedIndex(), "Date not allowed for CO2 fertilization (beta)");
-        H_ASSERT(has_biome( biome ), biome_error);
-        returnval = unitval(beta.at(biome), U_UNITLESS);
+        H_ASSERT(i_biome >= 0, biome_error);
+        returnval = unitval(beta[ i_biome ], U_UNITLESS);
     } else if(varNameParsed == D_Q10_RH) {
         H_ASSERT(date == Core::undefinedIndex(), "Date not allowed for Q10");
-        returnval = unitval(q10_rh.at( biome ), U_UNITLESS);
+        H_ASSERT(i_biome >= 0, biome_error);
+        returnval = unitval(q10_rh[ i_biome ], U_UNITLESS);
     } else if( varNameParsed == D_LAND_CFLUX ) {
         if(date == Core::undefinedIndex())
             returnval = atmosland_flux;
@@ -528,13 +529,16 @@ unitval SimpleNbox::getData(const std::string& varName,
         // Partitioning parameters.
     } else if(varNameParsed == D_F_NPPV) {
         H_ASSERT(date == Core::undefinedIndex(), "Date not allowed for vegetation NPP fraction");
-        returnval = unitval(f_nppv.at( biome ), U_UNITLESS);
+        H_ASSERT(i_biome >= 0, biome_error);
+        returnval = unitval(f_nppv[ i_biome ], U_UNITLESS);
     } else if(varNameParsed == D_F_NPPD) {
         H_ASSERT(date == Core::undefinedIndex(), "Date not allowed for detritus NPP fraction");
-        returnval = unitval(f_nppd.at( biome ), U_UNITLESS);
+        H_ASSERT(i_biome >= 0, biome_error);
+        returnval = unitval(f_nppd[ i_biome ], U_UNITLESS);
     } else if(varNameParsed == D_F_LITTERD) {
         H_ASSERT(date == Core::undefinedIndex(), "Date not allowed for litter-detritus fraction");
-        returnval = unitval(f_litterd.at( biome ), U_UNITLESS);
+        H_ASSERT(i_biome >= 0, biome_error);
+        returnval = unitval(f_litterd[ i_biome ], U_UNITLESS);
     } else if(varNameParsed == D_F_LUCV) {
         H_ASSERT(date == Core::undefinedIndex(), "Date not allowed for LUC vegetation fraction");
         returnval = unitval(f_lucv, U_UNITLESS);
@@ -550,46 +554,46 @@ unitval SimpleNbox::getData(const std::string& varName,
     } else if( varNameParsed == D_VEGC ) {
         if(biome == SNBOX_DEFAULT_BIOME) {
             if(date == Core::undefinedIndex())
-                returnval = sum_map( veg_c );
+                returnval.set( sum_vector( veg_c ), U_PGC );
             else
-                returnval = sum_map(veg_c_tv.get(date));
+                returnval.set( history_sum( veg_c_tv.get(date) ), U_PGC );
         } else {
-            H_ASSERT(has_biome( biome ), biome_error);
+            H_ASSERT(i_biome >= 0, biome_error);
             if(date == Core::undefinedIndex())
-                returnval = veg_c.at(biome) ;
+                returnval.set( veg_c[ i_biome ], U_PGC );
             else
-                returnval = veg_c_tv.get(date).at(biome);
+                returnval.set( history_value( veg_c_tv.get(date), i_biome, 0.0 ), U_PGC );
         }
     } else if( varNameParsed == D_DETRITUSC ) {
         if(biome == SNBOX_DEFAULT_BIOME) {
             if(date == Core::undefinedIndex())
-                returnval = sum_map( detritus_c );
+                returnval.set( sum_vector( detritus_c ), U_PGC );
             else
-                returnval = sum_map(detritus_c_tv.get(date));
+                returnval.set( history_sum( detritus_c_tv.get(date) ), U_PGC );
         } else {
-            H_ASSERT(has_biome( biome ), biome_error);
+            H_ASSERT(i_biome >= 0, biome_error);
             if(date == Core::undefinedIndex())
-                returnval = detritus_c.at(biome) ;
+                returnval.set( detritus_c[ i_biome ], U_PGC );
             else
-                returnval = detritus_c_tv.get(date).at(biome);
+                returnval.set( history_value( detritus_c_tv.get(date), i_biome, 0.0 ), U_PGC );
         }
     } else if( varNameParsed == D_SOILC ) {
         if(biome == SNBOX_DEFAULT_BIOME) {
             if(date == Core::undefinedIndex())
-                returnval = sum_map( soil_c );
+                returnval.set( sum_vector( soil_c ), U_PGC );
             else
-                returnval = sum_map(soil_c_tv.get(date));
+                returnval.set( history_sum( soil_c_tv.get(date) ), U_PGC );
         } else {
-            H_ASSERT(has_biome( biome ), biome_error);
+            H_ASSERT(i_biome >= 0, biome_error);
             if(date == Core::undefinedIndex())
-                returnval = soil_c.at(biome);
+                returnval.set( soil_c[ i_biome ], U_PGC );
             else
-                returnval = soil_c_tv.get(date).at(biome);
+                returnval.set( history_value( soil_c_tv.get(date), i_biome, 0.0 ), U_PGC );
         }
     } else if( varNameParsed == D_NPP_FLUX0 ) {
       H_ASSERT(date == Core::undefinedIndex(), "Date not allowed for npp_flux0" );
-      H_ASSERT(has_biome( biome ), biome_error);
-      returnval = npp_flux0.at(biome);
+      H_ASSERT(i_biome >= 0, biome_error);
+      returnval = unitval(npp_flux0[ i_biome ], U_PGC_YR);
     } else if( varNameParsed == D_FFI_EMISSIONS ) {
         H_ASSERT( date != Core::undefinedIndex(), "Date required for ffi emissions" );
         returnval = ffiEmissions.get( date );
@@ -626,26 +630,26 @@ void SimpleNbox::reset(double time)
     atmos_c = atmos_c_ts.get(time);
     Ca = Ca_ts.get(time);
 
-    veg_c = veg_c_tv.get(time);
-    detritus_c = detritus_c_tv.get(time);
-    soil_c = soil_c_tv.get(time);
+    from_history_row( veg_c_tv.get(time), veg_c, 0.0 );
+    from_history_row( detritus_c_tv.get(time), detritus_c, 0.0 );
+    from_history_row( soil_c_tv.get(time), soil_c, 0.0 );
 
     residual = residual_ts.get(time);
 
-    tempferts = tempferts_tv.get(time);
-    tempfertd = tempfertd_tv.get(time);
+    from_history_row( tempferts_tv.get(time), tempferts, 1.0 );
+    from_history_row( tempfertd_tv.get(time), tempfertd, 1.0 );
 
     // Calculate derived quantities
-    for( auto it = biome_list.begin(); it != biome_list.end(); it++ ) {
-        std::string biome = *it;
+    for( int i = 0; i < nbiomes(); i++ ) {
         if(in_spinup) {
-            co2fert[ biome ] = 1.0; // co2fert fixed if in spinup.  Placeholder in case we decide to allow resetting into spinup
+            co2fert[ i ] = 1.0; // co2fert fixed if in spinup.  Placeholder in case we decide to allow resetting into spinup
         }
         else {
-            co2fert[ biome ] = calc_co2fert(biome);
+            co2fert[ i ] = calc_co2fert( i );
         }
     }
     Tgav_record.truncate(time);
+    Tgav_window_t = Core::undefinedIndex(); // rebuilt from the truncated record on the next step
     // No need to reset masstot; it's not supposed to change anyhow.
 
     // Truncate all of the state variable time series
@@ -691,9 +695,10 @@ void SimpleNbox::accept( AVisitor* visitor ) {
 void SimpleNbox::getCValues( double t, double c[] )
 {
     c[ SNBOX_ATMOS ] = atmos_c.value( U_PGC );
-    c[ SNBOX_VEG ] = sum_map( veg_c ).value( U_PGC );
-    c[ SNBOX_DET ] = sum_map( detritus_c ).value( U_PGC );
-    c[ SNBOX_SOIL ] = sum_map( soil_c ).value( U_PGC );
+    const int nb = nbiomes();
+    std::copy( veg_c.begin(), veg_c.end(), c + SNBOX_NGLOBAL );
+    std::copy( detritus_c.begin(), detritus_c.end(), c + SNBOX_NGLOBAL + nb );
+    std::copy( soil_c.begin(), soil_c.end(), c + SNBOX_NGLOBAL + 2 * nb );
     omodel->getCValues( t, c );
     c[ SNBOX_EARTH ] = earth_c.value( U_PGC );
 
@@ -716,13 +721,18 @@ void SimpleNbox::stashCValues( double t, const double c[] )
     const double yf = ( t - ODEstartdate );
     H_ASSERT( yf >= 0 && yf <= 1, "yearfraction out of bounds" );
 
+    const int nb = nbiomes();
+    const double *cveg = c + SNBOX_NGLOBAL;
+    const double *cdet = cveg + nb;
+    const double *csoil = cdet + nb;
+
     H_LOG( logger,Logger::DEBUG ) << "Stashing at t=" << t << ", solver pools at " << t << ": " <<
-        "  atm = " << c[ 0 ] <<
-        "  veg = " << c[ 1 ] <<
-        "  det = " << c[ 2 ] <<
-        "  soil = " << c[ 3 ] <<
-        "  ocean = " << c[ 4 ] <<
-        "  earth = " << c[ 5 ] << std::endl;
+        "  atm = " << c[ SNBOX_ATMOS ] <<
+        "  veg = " << std::accumulate( cveg, cveg + nb, 0.0 ) <<
+        "  det = " << std::accumulate( cdet, cdet + nb, 0.0 ) <<
+        "  soil = " << std::accumulate( csoil, csoil + nb, 0.0 ) <<
+        "  ocean = " << c[ SNBOX_OCEAN ] <<
+        "  earth = " << c[ SNBOX_EARTH ] << std::endl;
 
     log_pools( t );
 
@@ -738,32 +748,12 @@ void SimpleNbox::stashCValues( double t, const double c[] )
     atmosland_flux = npp_total - rh_total - lucEmissions.get( t );
     atmosland_flux_ts.set(t, atmosland_flux);
 
-    // The solver just knows about one vegetation box, one detritus, and one
-    // soil. So we need to apportion new veg C pool (set by the solver) to
-    // as many biomes as we have. This is not ideal.
-    // TODO: Solver actually solves all boxes in multi-biome system
-
-    // Apportioning is done by NPP and RH
-    // i.e., biomes with higher values get more of any C change
-    const unitval npp_rh_total = npp_total + rh_total; // these are both positive
-    const unitval newveg( c[ SNBOX_VEG ], U_PGC );
-    const unitval newdet( c[ SNBOX_DET ], U_PGC );
-    const unitval newsoil( c[ SNBOX_SOIL ], U_PGC );
-    unitval veg_delta = newveg - sum_map( veg_c );  // TODO: make const
-    unitval det_delta = newdet - sum_map( detritus_c );  // TODO: make const
-    unitval soil_delta = newsoil - sum_map( soil_c );  // TODO: make const
-    H_LOG( logger,Logger::DEBUG ) << "veg_delta = " << veg_delta << std::endl;
-    H_LOG( logger,Logger::DEBUG ) << "det_delta = " << det_delta << std::endl;
-    H_LOG( logger,Logger::DEBUG ) << "soil_delta = " << soil_delta << std::endl;
-
-    for( auto it = biome_list.begin(); it != biome_list.end(); it++ ) {
-        std::string biome = *it;
-        const double wt     = ( npp( biome ) + rh( biome ) ) / npp_rh_total;
-        veg_c[ biome ]      = veg_c.at( biome ) + veg_delta * wt;
-        detritus_c[ biome ] = detritus_c.at( biome ) + det_delta * wt;
-        soil_c[ biome ]     = soil_c.at( biome ) + soil_delta * wt;
-        H_LOG( logger,Logger::DEBUG ) << "Biome " << biome << " weight = " << wt << std::endl;
-    }
+    // The solver integrates every biome's pools separately, so we just
+    // copy them back.
+    veg_c.assign( cveg, cveg + nb );
+    detritus_c.assign( cdet, cdet + nb );
+    soil_c.assign( csoil, csoil + nb );
+    calc_land_fluxes();     // in case the solver continues from here (retry)
 
     log_pools( t );
 
@@ -823,21 +813,27 @@ void SimpleNbox::stashCValues( double t, const double c[] )
 
 // A series of small functions to calculate variables that will appear in the output stream
 
-double SimpleNbox::calc_co2fert(std::string biome, double time) const
+double SimpleNbox::calc_co2fert(const int biome, double time) const
 {
     unitval Ca_t = time == Core::undefinedIndex() ? Ca : Ca_ts.get(time);
-    return 1 + beta.at(biome) * log(Ca_t/C0);
+    return 1 + beta[ biome ] * log(Ca_t/C0);
 }
 
 //------------------------------------------------------------------------------
 /*! \brief      Compute annual net primary production
- *  \returns    current annual NPP
+ *  \returns    current annual NPP, or missing in years the carbon cycle isn't run
  */
-unitval SimpleNbox::npp(std::string biome, double time) const
+unitval SimpleNbox::npp(const int biome, double time) const
 {
-    unitval npp = npp_flux0.at( biome );    // 'at' throws exception if not found
+    const bool skipped = time == Core::undefinedIndex() ? cycle_skipped
+        : core->concentrationDriven() && atmosphere_prescribed( time );
+    if( skipped ) {
+        return unitval( MISSING_FLOAT, U_PGC_YR );
+    }
+
+    unitval npp( npp_flux0[ biome ], U_PGC_YR );
     if(time == Core::undefinedIndex()) {
-        npp = npp * co2fert.at( biome );        // that's why used here instead of []
+        npp = npp * co2fert[ biome ];
     }
     else {
         npp = npp * calc_co2fert(biome, time);
@@ -852,8 +848,8 @@ unitval SimpleNbox::npp(std::string biome, double time) const
 unitval SimpleNbox::sum_npp(double time) const
 {
     unitval total( 0.0, U_PGC_YR );
-    for( auto it = biome_list.begin(); it != biome_list.end(); it++ ) {
-        total = total + npp( *it, time );}
+    for( int i = 0; i < nbiomes(); i++ ) {
+        total = total + npp( i, time );}
     return total;
 }
 
@@ -861,28 +857,33 @@ unitval SimpleNbox::sum_npp(double time) const
 /*! \brief      Compute detritus component of annual heterotrophic respiration
  *  \returns    current detritus component of annual heterotrophic respiration
  */
-unitval SimpleNbox::rh_fda( std::string biome ) const
+unitval SimpleNbox::rh_fda( const int biome ) const
 {
-    unitval dflux( detritus_c.at( biome ).value( U_PGC ) * 0.25, U_PGC_YR );
-    return dflux * tempfertd.at( biome );
+    unitval dflux( detritus_c[ biome ] * 0.25, U_PGC_YR );
+    return dflux * tempfertd[ biome ];
 }
 
 //------------------------------------------------------------------------------
 /*! \brief      Compute soil component of annual heterotrophic respiration
  *  \returns    current soil component of annual heterotrophic respiration
  */
-unitval SimpleNbox::rh_fsa( std::string biome ) const
+unitval SimpleNbox::rh_fsa( const int biome ) const
 {
-    unitval soilflux( soil_c.at( biome ).value( U_PGC ) * 0.02, U_PGC_YR );
-    return soilflux * tempferts.at( biome );
+    unitval soilflux( soil_c[ biome ] * 0.02, U_PGC_YR );
+    return soilflux * tempferts[ biome ];
 }
 
 //------------------------------------------------------------------------------
 /*! \brief      Compute total annual heterotrophic respiration
- *  \returns    current annual heterotrophic respiration
+ *  \returns    current annual heterotrophic respiration, or missing in years
+ *              the carbon cycle isn't run
  */
-unitval SimpleNbox::rh( std::string biome ) const
+unitval SimpleNbox::rh( const int biome ) const
 {
+    if( cycle_skipped ) {
+        return unitval( MISSING_FLOAT, U_PGC_YR );
+    }
+
     // Heterotrophic respiration is the sum of fluxes from detritus and soil
     return rh_fda( biome ) + rh_fsa( biome );
 }
@@ -894,8 +895,8 @@ unitval SimpleNbox::rh( std::string biome ) const
 unitval SimpleNbox::sum_rh() const
 {
     unitval total( 0.0, U_PGC_YR );
-    for( auto it = biome_list.begin(); it != biome_list.end(); it++ ) {
-        total = total + rh( *it );
+    for( int i = 0; i < nbiomes(); i++ ) {
+        total = total + rh( i );
     }
     return total;
 }
@@ -906,6 +907,9 @@ unitval SimpleNbox::sum_rh() const
  *  \param[in]  c       carbon pools (no units)
  *  \param[out] dcdt    carbon fluxes
  *  \returns            code indicating success or failure
+ *
+ *  All quantities here are plain doubles (Pg C and Pg C/yr); each biome's
+ *  pools get their own derivatives.
  */
 int SimpleNbox::calcderivs( double t, const double c[], double dcdt[] ) const
 {
@@ -915,104 +919,60 @@ int SimpleNbox::calcderivs( double t, const double c[], double dcdt[] ) const
 
     // Atmosphere-ocean flux is calculated by ocean_component
     const int omodel_err = omodel->calcderivs( t, c, dcdt );
-    unitval atmosocean_flux( dcdt[ SNBOX_OCEAN ], U_PGC_YR );
-
-    /// NPP: Net primary productivity
-    unitval npp_biome( 0.0, U_PGC_YR);
-    unitval npp_current( 0.0, U_PGC_YR );
-    unitval npp_fav( 0.0, U_PGC_YR );
-    unitval npp_fad( 0.0, U_PGC_YR );
-    unitval npp_fas( 0.0, U_PGC_YR );
-
-    // RH: heterotrophic respiration
-    unitval rh_fda_current( 0.0, U_PGC_YR );
-    unitval rh_fsa_current( 0.0, U_PGC_YR );
-
-    for( auto it = biome_list.begin(); it != biome_list.end(); it++ ) {
-        std::string biome = *it;
-        // NPP is scaled by CO2 from preindustrial value
-        npp_biome = npp( biome );
-        npp_current = npp_current + npp_biome;
-        npp_fav = npp_fav + npp_biome * f_nppv.at( biome );
-        npp_fad = npp_fad + npp_biome * f_nppd.at( biome );
-        npp_fas = npp_fas + npp_biome * (1 - f_nppv.at( biome ) - f_nppd.at( biome ));
-        rh_fda_current = rh_fda_current + rh_fda( biome );
-        rh_fsa_current = rh_fsa_current + rh_fsa( biome );
-    }
-    unitval rh_current = rh_fda_current + rh_fsa_current;
+    const double atmosocean_flux = dcdt[ SNBOX_OCEAN ];
 
-    // Detritus flux comes from the vegetation pool
-    // TODO: these values should use the c[] pools passed in by solver!
-    unitval litter_flux( 0.0, U_PGC_YR );
-    unitval litter_fvd( 0.0, U_PGC_YR );
-    unitval litter_fvs( 0.0, U_PGC_YR );
-    for( auto it = biome_list.begin(); it != biome_list.end(); it++ ) {
-        std::string biome = *it;
-        unitval v = unitval( veg_c.at( biome ).value( U_PGC ) * 0.035, U_PGC_YR );
-        litter_flux = litter_flux + v;
-        litter_fvd = litter_fvd + v * f_litterd.at( biome );
-        litter_fvs = litter_fvs + v * ( 1 - f_litterd.at( biome ) );
-    }
-
-    // Some detritus goes to soil
-    unitval detsoil_flux( 0.0, U_PGC_YR );
-    for( auto it = biome_list.begin(); it != biome_list.end(); it++ ) {
-        std::string biome = *it;
-        detsoil_flux = detsoil_flux + unitval( detritus_c.at( biome ).value( U_PGC ) * 0.6, U_PGC_YR );
-    }
+    const int nb = nbiomes();
+    double *dveg = dcdt + SNBOX_NGLOBAL;
+    double *ddet = dveg + nb;
+    double *dsoil = ddet + nb;
 
     // Annual fossil fuels and industry emissions
-    unitval ffi_flux_current( 0.0, U_PGC_YR );
+    double ffi_flux_current = 0.0;
     if( !in_spinup ) {   // no perturbation allowed if in spinup
-        ffi_flux_current = ffiEmissions.get( t );
+        ffi_flux_current = ffiEmissions.get( t ).value( U_PGC_YR );
     }
 
     // Annual land use change emissions
-    unitval luc_current( 0.0, U_PGC_YR );
+    double luc_current = 0.0;
     if( !in_spinup ) {   // no perturbation allowed if in spinup
-        luc_current = lucEmissions.get( t );
+        luc_current = lucEmissions.get( t ).value( U_PGC_YR );
     }
 
-    // Land-use change contribution can come from veg, detritus, and soil
-    unitval luc_fva = luc_current * f_lucv;
-    unitval luc_fda = luc_current * f_lucd;
-    unitval luc_fsa = luc_current * ( 1 - f_lucv - f_lucd );
+    // Land-use change contribution can come from veg, detritus, and soil.
+    // Within each of those, it is taken from the biomes in proportion to
+    // their pool sizes.
+    const double luc_fva = luc_current * f_lucv;
+    const double luc_fda = luc_current * f_lucd;
+    const double luc_fsa = luc_current * ( 1 - f_lucv - f_lucd );
 
     // Oxidized methane of fossil fuel origin
-    unitval ch4ox_current( 0.0, U_PGC_YR );     //TODO: implement this
+    const double ch4ox_current = 0.0;     //TODO: implement this
+
+    // TODO: these values should use the c[] pools passed in by solver!
+    // Until they do, everything but land-use change is fixed over the
+    // time step (see calc_land_fluxes).
+    H_ASSERT( int( dveg_step.size() ) == nb, "land fluxes not computed for current biomes" );
+    for( int i = 0; i < nb; i++ ) {
+        dveg[ i ] = dveg_step[ i ] - luc_fva * luc_share_veg[ i ];
+        ddet[ i ] = ddet_step[ i ] - luc_fda * luc_share_det[ i ];
+        dsoil[ i ] = dsoil_step[ i ] - luc_fsa * luc_share_soil[ i ];
+    }
+    const double npp_current = npp_step;
+    const double rh_current = rh_fda_step + rh_fsa_step;
 
     // Compute fluxes
     dcdt[ SNBOX_ATMOS ] = // change in atmosphere pool
-        ffi_flux_current.value( U_PGC_YR )
-        + luc_current.value( U_PGC_YR )
-        + ch4ox_current.value( U_PGC_YR )
-        - atmosocean_flux.value( U_PGC_YR )
-        - npp_current.value( U_PGC_YR )
-        + rh_current.value( U_PGC_YR );
-    dcdt[ SNBOX_VEG ] = // change in vegetation pool
-        npp_fav.value( U_PGC_YR )
-        - litter_flux.value( U_PGC_YR )
-        - luc_fva.value( U_PGC_YR );
-    dcdt[ SNBOX_DET ] = // change in detritus pool
-        npp_fad.value( U_PGC_YR )
-        + litter_fvd.value( U_PGC_YR )
-        - detsoil_flux.value( U_PGC_YR )
-        - rh_fda_current.value( U_PGC_YR )
-        - luc_fda.value( U_PGC_YR );
-    dcdt[ SNBOX_SOIL ] = // change in soil pool
-        npp_fas.value( U_PGC_YR )
-        + litter_fvs.value( U_PGC_YR )
-        + detsoil_flux.value( U_PGC_YR )
-        - rh_fsa_current.value( U_PGC_YR )
-        - luc_fsa.value( U_PGC_YR );
+        ffi_flux_current
+        + luc_current
+        + ch4ox_current
+        - atmosocean_flux
+        - npp_current
+        + rh_current;
     dcdt[ SNBOX_OCEAN ] = // change in ocean pool
-        atmosocean_flux.value( U_PGC_YR );
+        atmosocean_flux;
     dcdt[ SNBOX_EARTH ] = // change in earth pool
-        - ffi_flux_current.value( U_PGC_YR );
+        - ffi_flux_current;
 
-/*    printf( "%6.3f%8.3f%8.2f%8.2f%8.2f%8.2f%8.2f\n", t, dcdt[ SNBOX_ATMOS ],
-            dcdt[ SNBOX_VEG ], dcdt[ SNBOX_DET ], dcdt[ SNBOX_SOIL ], dcdt[ SNBOX_OCEAN ], dcdt[ SNBOX_EARTH ] );
-*/
     return omodel_err;
 }
 
@@ -1033,14 +993,13 @@ void SimpleNbox::slowparameval( double t, const double c[] )
     Ca.set( c[ SNBOX_ATMOS ] * PGC_TO_PPMVCO2, U_PPMV_CO2 );
 
     // Compute CO2 fertilization factor globally (and for each biome specified)
-    for( auto it = biome_list.begin(); it != biome_list.end(); it++ ) {
-        std::string biome = *it;
+    for( int i = 0; i < nbiomes(); i++ ) {
         if( in_spinup ) {
-            co2fert[ biome ] = 1.0;  // no perturbation allowed if in spinup
+            co2fert[ i ] = 1.0;  // no perturbation allowed if in spinup
         } else {
-            co2fert[ biome ] = calc_co2fert( biome );
+            co2fert[ i ] = calc_co2fert( i );
         }
-        H_LOG( logger,Logger::DEBUG ) << "co2fert[ " << biome << " ] at " << Ca << " = " << co2fert.at( biome ) << std::endl;
+        H_LOG( logger,Logger::DEBUG ) << "co2fert[ " << biome_list[ i ] << " ] at " << Ca << " = " << co2fert[ i ] << std::endl;
     }
 
     // Compute temperature factor globally (and for each biome specified)
@@ -1054,64 +1013,149 @@ void SimpleNbox::slowparameval( double t, const double c[] )
     // Need the previous time step values of tempferts.  Since t is
     // the time at the beginning of the current time step (== the end
     // of the previous time step), we can use t as the index to look
-    // up the previous value.
-    double_stringmap tfs_last;  // Previous time step values of tempferts; initialized empty
+    // up the previous value.  That step must have been recorded, so
+    // `get` throws if it is missing.
+    const history_row_t *tfs_last = NULL;  // Previous time step values of tempferts, if any
     if(t != Core::undefinedIndex() && t > core->getStartDate()) {
-        tfs_last = tempferts_tv[t];
+        tfs_last = &tempferts_tv.get(t);
+    }
+
+    // The window mean is the same for every biome (up to the warming
+    // factor), so compute it once per step.
+    double Tgav_rm_global = 0.0;
+    if( !in_spinup && t > core->getStartDate() + Q10_TEMPLAG ) {
+        Tgav_rm_global = Tgav_window_mean( t );
     }
 
     // Loop over biomes.
-    for( auto it = biome_list.begin(); it != biome_list.end(); it++ ) {
-        std::string biome = *it;
+    for( int i = 0; i < nbiomes(); i++ ) {
         if( in_spinup ) {
-            tempfertd[ biome ] = 1.0;  // no perturbation allowed in spinup
-            tempferts[ biome ] = 1.0;  // no perturbation allowed in spinup
+            tempfertd[ i ] = 1.0;  // no perturbation allowed in spinup
+            tempferts[ i ] = 1.0;  // no perturbation allowed in spinup
         } else {
-            double wf;
-            if( warmingfactor.count( biome ) ) {
-                wf = warmingfactor.at( biome );   // biome-specific warming
-            } else if ( warmingfactor.count( SNBOX_DEFAULT_BIOME ) ) {
-                wf = warmingfactor.at( SNBOX_DEFAULT_BIOME );
-            } else {
-                wf = 1.0;
-            }
+            const double wf = warmingfactor[ i ];   // biome-specific warming
 
             const double Tgav_biome = Tgav * wf;    // biome-specific temperature
 
-            tempfertd[ biome ] = pow( q10_rh.at( biome ), ( Tgav_biome / 10.0 ) ); // detritus warms with air
+            tempfertd[ i ] = pow( q10_rh[ i ], ( Tgav_biome / 10.0 ) ); // detritus warms with air
 
 
             // Soil warm very slowly relative to the atmosphere
             // We use a mean temperature of a window (size Q10_TEMPN) of temperatures to scale Q10
-            #define Q10_TEMPLAG 0 //125         // TODO: put lag in input files 150, 25
-            #define Q10_TEMPN 200 //25
-            double Tgav_rm = 0.0;       /* window mean of Tgav */
-            if( t > core->getStartDate() + Q10_TEMPLAG ) {
-                for( int i=t-Q10_TEMPLAG-Q10_TEMPN; i<t-Q10_TEMPLAG; i++ ) {
-                    Tgav_rm += Tgav_record.get( i ) * wf;
-                }
-                Tgav_rm /= Q10_TEMPN;
-            }
+            const double Tgav_rm = Tgav_rm_global * wf;     /* window mean of Tgav */
 
-            tempferts[ biome ] = pow( q10_rh.at( biome ), ( Tgav_rm / 10.0 ) );
+            tempferts[ i ] = pow( q10_rh[ i ], ( Tgav_rm / 10.0 ) );
 
             // The soil Q10 effect is 'sticky' and can only increase, not decline
-            double tempferts_last = tfs_last[ biome ]; // If tfs_last is empty, this will produce 0.0
-            if(tempferts[ biome ] < tempferts_last) {
-                tempferts[ biome ] = tempferts_last;
+            const double tempferts_last = tfs_last ? history_value( *tfs_last, i, 1.0 ) : 0.0;
+            if(tempferts[ i ] < tempferts_last) {
+                tempferts[ i ] = tempferts_last;
             }
 
-            H_LOG( logger,Logger::DEBUG ) << biome << " Tgav=" << Tgav << ", Tgav_biome=" << Tgav_biome << ", tempfertd=" << tempfertd[ biome ]
-                << ", tempferts=" << tempferts[ biome ] << std::endl;
+            H_LOG( logger,Logger::DEBUG ) << biome_list[ i ] << " Tgav=" << Tgav << ", Tgav_biome=" << Tgav_biome << ", tempfertd=" << tempfertd[ i ]
+                << ", tempferts=" << tempferts[ i ] << std::endl;
         }
     } // loop over biomes
+    calc_land_fluxes();
+
     // save the new values for use in the next time step
     // TODO:  move this to a purpose-built recording subroutine
     //tempferts_tv.set(tcurrent, tempferts);
-    H_LOG(logger, Logger::DEBUG) << "slowparameval: would have recorded tempferts = " << tempferts[SNBOX_DEFAULT_BIOME]
+    H_LOG(logger, Logger::DEBUG) << "slowparameval: would have recorded tempferts = " << tempferts[ 0 ]
                                  << " at time= " << tcurrent << std::endl;
 }
 
+//------------------------------------------------------------------------------
+/*! \brief  Compute the per-biome land fluxes for the coming time step
+ *
+ *  NPP, respiration, and litter fluxes are evaluated from the pools and
+ *  the fertilization factors at the start of the step, so they don't
+ *  change while the solver works through the step.  Each biome's share
+ *  of land-use change emissions is fixed in the same way; only the
+ *  total emissions vary with time, and calcderivs applies them.
+ */
+void SimpleNbox::calc_land_fluxes()
+{
+    const int nb = nbiomes();
+    dveg_step.resize( nb );
+    ddet_step.resize( nb );
+    dsoil_step.resize( nb );
+    luc_share_veg.resize( nb );
+    luc_share_det.resize( nb );
+    luc_share_soil.resize( nb );
+
+    const double veg_total = sum_vector( veg_c );
+    const double det_total = sum_vector( detritus_c );
+    const double soil_total = sum_vector( soil_c );
+
+    npp_step = rh_fda_step = rh_fsa_step = 0.0;
+    for( int i = 0; i < nb; i++ ) {
+        /// NPP: Net primary productivity, scaled by CO2 from preindustrial value
+        const double npp_biome = npp_flux0[ i ] * co2fert[ i ];
+        const double npp_fav = npp_biome * f_nppv[ i ];
+        const double npp_fad = npp_biome * f_nppd[ i ];
+        const double npp_fas = npp_biome * ( 1 - f_nppv[ i ] - f_nppd[ i ] );
+
+        // RH: heterotrophic respiration
+        const double rh_fda_biome = detritus_c[ i ] * 0.25 * tempfertd[ i ];
+        const double rh_fsa_biome = soil_c[ i ] * 0.02 * tempferts[ i ];
+
+        // Detritus flux comes from the vegetation pool
+        const double litter_flux = veg_c[ i ] * 0.035;
+        const double litter_fvd = litter_flux * f_litterd[ i ];
+        const double litter_fvs = litter_flux * ( 1 - f_litterd[ i ] );
+
+        // Some detritus goes to soil
+        const double detsoil_flux = detritus_c[ i ] * 0.6;
+
+        dveg_step[ i ] = npp_fav - litter_flux;
+        ddet_step[ i ] = npp_fad + litter_fvd - detsoil_flux - rh_fda_biome;
+        dsoil_step[ i ] = npp_fas + litter_fvs + detsoil_flux - rh_fsa_biome;
+
+        luc_share_veg[ i ] = veg_total > 0.0 ? veg_c[ i ] / veg_total : 0.0;
+        luc_share_det[ i ] = det_total > 0.0 ? detritus_c[ i ] / det_total : 0.0;
+        luc_share_soil[ i ] = soil_total > 0.0 ? soil_c[ i ] / soil_total : 0.0;
+
+        npp_step += npp_biome;
+        rh_fda_step += rh_fda_biome;
+        rh_fsa_step += rh_fsa_biome;
+    }
+}
+
+//------------------------------------------------------------------------------
+/*! \brief      Number of spinup state variables
+ *  \details    During spinup the atmosphere is held at C0 and there is no
+ *              exchange with the earth pool, so the state that drifts is the
+ *              biome pools and the ocean boxes.
+ */
+int SimpleNbox::nspinupstate() const
+{
+    return 3 * nbiomes() + omodel->nspinupstate();
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+void SimpleNbox::getSpinupState( double x[] ) const
+{
+    const int nb = nbiomes();
+    std::copy( veg_c.begin(), veg_c.end(), x );
+    std::copy( detritus_c.begin(), detritus_c.end(), x + nb );
+    std::copy( soil_c.begin(), soil_c.end(), x + 2 * nb );
+    omodel->getSpinupState( x + 3 * nb );
+}
+
+//------------------------------------------------------------------------------
+// documentation is inherited
+void SimpleNbox::setSpinupState( const double x[] )
+{
+    const int nb = nbiomes();
+    veg_c.assign( x, x + nb );
+    detritus_c.assign( x + nb, x + 2 * nb );
+    soil_c.assign( x + 2 * nb, x + 3 * nb );
+    omodel->setSpinupState( x + 3 * nb );
+    calc_land_fluxes();
+}
+
 void SimpleNbox::record_state(double t)
 {
     tcurrent = t;
@@ -1119,21 +1163,47 @@ void SimpleNbox::record_state(double t)
     atmos_c_ts.set(t, atmos_c);
     Ca_ts.set(t, Ca);
 
-    veg_c_tv.set(t, veg_c);
-    detritus_c_tv.set(t, detritus_c);
-    soil_c_tv.set(t, soil_c);
+    veg_c_tv.set(t, history_row( veg_c ));
+    detritus_c_tv.set(t, history_row( detritus_c ));
+    soil_c_tv.set(t, history_row( soil_c ));
 
     residual_ts.set(t, residual);
 
-    tempfertd_tv.set(t, tempfertd);
-    tempferts_tv.set(t, tempferts);
-    H_LOG(logger, Logger::DEBUG) << "record_state: recorded tempferts = " << tempferts[SNBOX_DEFAULT_BIOME]
+    tempfertd_tv.set(t, history_row( tempfertd ));
+    tempferts_tv.set(t, history_row( tempferts ));
+    H_LOG(logger, Logger::DEBUG) << "record_state: recorded tempferts = " << tempferts[ 0 ]
                                  << " at time= " << t << std::endl;
 
     omodel->record_state(t);
 
 }
 
+//------------------------------------------------------------------------------
+/*! \brief                  Set atmospheric CO2 from the user-supplied constraint
+ *  \param[in] t            Date
+ *
+ *  Used in concentration-driven runs, in years where the carbon cycle isn't
+ *  run.  The land and ocean pools keep their values, the net land flux is
+ *  zero, and NPP and RH are reported as missing.
+ */
+void SimpleNbox::prescribe_atmosphere(double t)
+{
+    H_ASSERT( atmosphere_prescribed( t ), "No CO2 constraint for " + boost::lexical_cast<std::string>( t ) );
+
+    Ca = CO2_constrain.get( t );
+    atmos_c.set( Ca.value( U_PPMV_CO2 ) / PGC_TO_PPMVCO2, U_PGC );
+    residual.set( 0.0, U_PGC );
+    atmosland_flux.set( 0.0, U_PGC_YR );
+    atmosland_flux_ts.set( t, atmosland_flux );
+
+    // Carbon isn't conserved when the atmosphere is prescribed, so restart
+    // the mass conservation check
+    masstot = 0.0;
+
+    ODEstartdate = t;
+    record_state( t );
+}
+
 // Set the preindustrial carbon value and adjust total mass to reflect the new
 // value (unless it hasn't yet been set).  Note that after doing this,
 // attempting to run without first doing a reset will cause an exception due to
@@ -1150,9 +1220,255 @@ void SimpleNbox::set_c0(double newc0)
 
 }
 
+// Mean of Tgav_record over the years [t-Q10_TEMPLAG-Q10_TEMPN,
+// t-Q10_TEMPLAG).  The window values are kept in a ring buffer along
+// with their running sum, so advancing by one year costs one record
+// lookup.  Any other jump in t (first step, reset, rerun) rebuilds
+// the buffer from the record.
+double SimpleNbox::Tgav_window_mean( const double t )
+{
+    const int tnew = int( t ) - Q10_TEMPLAG - 1;   // newest year in the window
+    if( Tgav_window_t != Core::undefinedIndex() && t == Tgav_window_t + 1.0 ) {
+        // drop the oldest year; its slot is reused by the newest one
+        const int slot = ( tnew % Q10_TEMPN + Q10_TEMPN ) % Q10_TEMPN;
+        const double Tnew = Tgav_record.get( tnew );
+        Tgav_window_sum += Tnew - Tgav_window[ slot ];
+        Tgav_window[ slot ] = Tnew;
+    } else if( t != Tgav_window_t ) {
+        Tgav_window_sum = 0.0;
+        for( int yr = tnew - Q10_TEMPN + 1; yr <= tnew; yr++ ) {
+            const int slot = ( yr % Q10_TEMPN + Q10_TEMPN ) % Q10_TEMPN;
+            Tgav_window[ slot ] = Tgav_record.get( yr );
+            Tgav_window_sum += Tgav_window[ slot ];
+        }
+    }
+    Tgav_window_t = t;
+    return Tgav_window_sum / Q10_TEMPN;
+}
+
 // Check if `biome` is present in biome_list
-bool SimpleNbox::has_biome(const std::string& biome) {
-    return std::find(biome_list.begin(), biome_list.end(), biome) != biome_list.end();
+bool SimpleNbox::has_biome(const std::string& biome) const {
+    return biome_index( biome ) >= 0;
+}
+
+// Position of `biome` in biome_list (and therefore in all of the
+// biome arrays), or -1 if it isn't there
+int SimpleNbox::biome_index(const std::string& biome) const {
+    std::map<std::string, int>::const_iterator it = biome_pos.find( biome );
+    return it == biome_pos.end() ? -1 : it->second;
+}
+
+// Pack a biome array into a history row, indexed by history slot, and
+// stamp it with the write count
+SimpleNbox::history_row_t SimpleNbox::history_row( const double_vector& pool )
+{
+    history_row_t row;
+    row.value.assign( nslots, 0.0 );
+    for( int i = 0; i < nbiomes(); i++ ) {
+        row.value[ biome_slot[ i ] ] = pool[ i ];
+    }
+    row.written = history_writes++;
+    return row;
+}
+
+// Value of biome `i` in a history row, or `missing` if the row was
+// recorded before the biome was given its slot (when the slot is
+// empty or belonged to a deleted biome)
+double SimpleNbox::history_value( const history_row_t& row, const int i,
+                                  const double missing ) const
+{
+    const int slot = biome_slot[ i ];
+    return row.written >= slot_since[ slot ] ? row.value[ slot ] : missing;
+}
+
+// Unpack a history row into a biome array
+void SimpleNbox::from_history_row( const history_row_t& row, double_vector& pool,
+                                   const double missing ) const
+{
+    for( int i = 0; i < nbiomes(); i++ ) {
+        pool[ i ] = history_value( row, i, missing );
+    }
+}
+
+// Sum a history row over the biomes currently in `biome_list`
+double SimpleNbox::history_sum( const history_row_t& row ) const
+{
+    double sum = 0.0;
+    for( int i = 0; i < nbiomes(); i++ ) {
+        sum += history_value( row, i, 0.0 );
+    }
+    return sum;
+}
+
+// Append a biome to `biome_list` and extend every biome array to
+// match. Pools and parameters start out missing, so that
+// `prepareToRun` can tell whether they were ever set; the derived
+// quantities start at their no-effect values.
+void SimpleNbox::add_biome_data(const std::string& biome)
+{
+    biome_pos[ biome ] = nbiomes();
+    biome_list.push_back( biome );
+    // Reuse the slot of a deleted biome if there is one; either way,
+    // only rows written from now on belong to this biome
+    int slot;
+    if( free_slots.empty() ) {
+        slot = nslots++;
+        slot_since.push_back( history_writes );
+    } else {
+        slot = free_slots.back();
+        free_slots.pop_back();
+        slot_since[ slot ] = history_writes;
+    }
+    biome_slot.push_back( slot );
+
+    veg_c.push_back( MISSING_FLOAT );
+    detritus_c.push_back( MISSING_FLOAT );
+    soil_c.push_back( MISSING_FLOAT );
+    npp_flux0.push_back( MISSING_FLOAT );
+
+    beta.push_back( MISSING_FLOAT );
+    q10_rh.push_back( MISSING_FLOAT );
+    warmingfactor.push_back( MISSING_FLOAT );
+    f_nppv.push_back( MISSING_FLOAT );
+    f_nppd.push_back( MISSING_FLOAT );
+    f_litterd.push_back( MISSING_FLOAT );
+
+    co2fert.push_back( 1.0 );
+    tempfertd.push_back( 1.0 );
+    tempferts.push_back( 1.0 );
+
+    nc = SNBOX_NGLOBAL + 3 * nbiomes();
+}
+
+// Remove the biome at position `i` from `biome_list` and from every
+// biome array.  Its history slot goes on the free list; the recorded
+// rows are not touched.
+void SimpleNbox::erase_biome_data(const int i)
+{
+    free_slots.push_back( biome_slot[ i ] );
+
+    biome_pos.erase( biome_list[ i ] );
+    biome_list.erase( biome_list.begin() + i );
+    biome_slot.erase( biome_slot.begin() + i );
+    for( int j = i; j < nbiomes(); j++ ) {
+        biome_pos[ biome_list[ j ] ] = j;
+    }
+
+    veg_c.erase( veg_c.begin() + i );
+    detritus_c.erase( detritus_c.begin() + i );
+    soil_c.erase( soil_c.begin() + i );
+    npp_flux0.erase( npp_flux0.begin() + i );
+
+    beta.erase( beta.begin() + i );
+    q10_rh.erase( q10_rh.begin() + i );
+    warmingfactor.erase( warmingfactor.begin() + i );
+    f_nppv.erase( f_nppv.begin() + i );
+    f_nppd.erase( f_nppd.begin() + i );
+    f_litterd.erase( f_litterd.begin() + i );
+
+    co2fert.erase( co2fert.begin() + i );
+    tempfertd.erase( tempfertd.begin() + i );
+    tempferts.erase( tempferts.begin() + i );
+
+    nc = SNBOX_NGLOBAL + 3 * nbiomes();
+}
+
+// Remove the "global" biome, which cannot coexist with named biomes.
+// We don't use the `deleteBiome` function here because when this is
+// called while initializing the core from the INI file, most of the
+// time series variables that `deleteBiome` modifies have not been
+// initialized yet.  This should be relatively safe because (1) we
+// check consistency of biome-specific variable sizes before running,
+// and (2) the R interface will not let you use `setData` to modify
+// the biome list.
+void SimpleNbox::drop_global_biome()
+{
+    const int i_global = biome_index( SNBOX_DEFAULT_BIOME );
+    H_LOG( logger, Logger::DEBUG ) << "Removing biome '" << SNBOX_DEFAULT_BIOME <<
+        "' because you cannot have both 'global' and biome data. " << std::endl;
+    // Any pools already set for the global biome would be
+    // silently discarded here, so treat them as an error.
+    H_ASSERT( std::isnan( veg_c[ i_global ] ) && std::isnan( detritus_c[ i_global ] ) &&
+              std::isnan( soil_c[ i_global ] ) && std::isnan( npp_flux0[ i_global ] ),
+              "Cannot have both global and biome-specific data: "
+              "global pools not same size as biome_list" );
+    erase_biome_data( i_global );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief              Read biome data for many land cells from one CSV table
+ *  \param[in] fileName Name of the CSV file
+ *  \param[in] contents Contents of the file, if not to be read from disk
+ *
+ *  The table is read by CSVTableReader, so it follows the same rules as
+ *  other input tables (comments, white space, UNITS rows), except that
+ *  the first column holds the cell (biome) names.  The other columns
+ *  may be any of veg_c, detritus_c, soil_c, npp_flux0, beta, q10_rh,
+ *  f_nppv, f_nppd, f_litterd and warmingfactor, in Pg C, Pg C/yr, or
+ *  unitless, as appropriate.  Each row sets those values for one cell,
+ *  creating the cell if it doesn't exist yet; blank cells leave the
+ *  value unset.
+ *
+ *  This is equivalent to setting `<cell>.<variable>` for every entry
+ *  in the table, but the values go straight into the biome arrays, so
+ *  tables with thousands of cells load in a single pass.
+ */
+void SimpleNbox::read_cell_table( const std::string& fileName,
+                                  const std::shared_ptr<const std::string>& contents )
+{
+    CSVTableReader table( fileName, contents );
+    const std::vector<std::string> cells = table.getRowNames();
+    const std::vector<std::string> vars = table.getColumnNames();
+    H_ASSERT( !vars.empty(), "no data columns in land cell table " + fileName );
+
+    // Position of each row's cell in the biome arrays
+    std::vector<int> cell_index( cells.size() );
+    for( size_t row = 0; row < cells.size(); row++ ) {
+        const std::string& cell = cells[ row ];
+        H_ASSERT( !cell.empty(), "missing cell name in land cell table " + fileName );
+        H_ASSERT( cell.find( SNBOX_PARSECHAR ) == std::string::npos,
+                  "cell names may not contain '" SNBOX_PARSECHAR "': " + cell );
+
+        if( cell != SNBOX_DEFAULT_BIOME && has_biome( SNBOX_DEFAULT_BIOME ) ) {
+            drop_global_biome();
+        }
+        int i = biome_index( cell );
+        if( i < 0 ) {
+            H_ASSERT( !has_biome( SNBOX_DEFAULT_BIOME ),
+                      "If one of the biomes is 'global', you cannot add other biomes." );
+            add_biome_data( cell );
+            i = nbiomes() - 1;
+        }
+        cell_index[ row ] = i;
+    }
+
+    for( size_t col = 0; col < vars.size(); col++ ) {
+        const std::string& var = vars[ col ];
+        double_vector *target = NULL;
+        unit_types units = U_UNITLESS;
+        if( var == D_VEGC ) { target = &veg_c; units = U_PGC; }
+        else if( var == D_DETRITUSC ) { target = &detritus_c; units = U_PGC; }
+        else if( var == D_SOILC ) { target = &soil_c; units = U_PGC; }
+        else if( var == D_NPP_FLUX0 ) { target = &npp_flux0; units = U_PGC_YR; }
+        else if( var == D_BETA ) target = &beta;
+        else if( var == D_Q10_RH ) target = &q10_rh;
+        else if( var == D_F_NPPV ) target = &f_nppv;
+        else if( var == D_F_NPPD ) target = &f_nppd;
+        else if( var == D_F_LITTERD ) target = &f_litterd;
+        else if( var == D_WARMINGFACTOR ) target = &warmingfactor;
+        H_ASSERT( target, "unknown land cell variable '" + var + "' in " + fileName );
+
+        std::vector<unitval> values = table.getValues( var );
+        for( size_t row = 0; row < values.size(); row++ ) {
+            if( std::isnan( values[ row ].value( values[ row ].units() ) ) ) {
+                continue;
+            }
+            values[ row ].expecting_unit( units );
+            ( *target )[ cell_index[ row ] ] = values[ row ].value( units );
+        }
+    }
+
+    H_LOG( logger, Logger::NOTICE ) << "Read " << cells.size() << " land cells from " << fileName << std::endl;
 }
 
 // Create a new biome, and initialize it with zero C pools and fluxes
@@ -1166,35 +1482,30 @@ void SimpleNbox::createBiome(const std::string& biome)
     std::string errmsg = "Biome '" + biome + "' is already in `biome_list`.";
     H_ASSERT(!has_biome( biome ), errmsg);
 
-    // Initialize new pools
-    veg_c[ biome ] = unitval(0, U_PGC);
-    add_biome_to_ts(veg_c_tv, biome, veg_c.at( biome ));
-    detritus_c[ biome ] = unitval(0, U_PGC);
-    add_biome_to_ts(detritus_c_tv, biome, detritus_c.at( biome ));
-    soil_c[ biome ] = unitval(0, U_PGC);
-    add_biome_to_ts(soil_c_tv, biome, soil_c.at( biome ));
+    const int last_biome = nbiomes() - 1;
 
-    npp_flux0[ biome ] = unitval(0, U_PGC_YR);
+    // Add to end of biome list
+    add_biome_data( biome );
+    const int i = nbiomes() - 1;
 
-    // Other defaults (these will be re-calculated later)
-    co2fert[ biome ] = 1.0;
-    tempfertd[ biome ] = 1.0;
-    add_biome_to_ts(tempfertd_tv, biome, 1.0);
-    tempferts[ biome ] = 1.0;
-    add_biome_to_ts(tempferts_tv, biome, 1.0);
+    // Initialize new pools.  Rows recorded before the biome got its
+    // history slot don't belong to it, so earlier years read back as
+    // empty pools with no temperature effect (see `history_value`).
+    veg_c[ i ] = 0.0;
+    detritus_c[ i ] = 0.0;
+    soil_c[ i ] = 0.0;
 
-    std::string last_biome = biome_list.back();
+    npp_flux0[ i ] = 0.0;
 
     // Set parameters to same as most recent biome
-    beta[ biome ] = beta[ last_biome ];
-    q10_rh[ biome ] = q10_rh[ last_biome ];
-    warmingfactor[ biome ] = warmingfactor[ last_biome ];
-    f_nppv[ biome ] = f_nppv[ last_biome ];
-    f_nppd[ biome ] = f_nppd[ last_biome ];
-    f_litterd[ biome ] = f_litterd[ last_biome ];
-
-    // Add to end of biome list
-    biome_list.push_back(biome);
+    if( last_biome >= 0 ) {
+        beta[ i ] = beta[ last_biome ];
+        q10_rh[ i ] = q10_rh[ last_biome ];
+        warmingfactor[ i ] = warmingfactor[ last_biome ];
+        f_nppv[ i ] = f_nppv[ last_biome ];
+        f_nppd[ i ] = f_nppd[ last_biome ];
+        f_litterd[ i ] = f_litterd[ last_biome ];
+    }
 
     H_LOG(logger, Logger::DEBUG) << "Finished creating biome '" << biome << "'." << std::endl;}
 
@@ -1206,94 +1517,35 @@ void SimpleNbox::deleteBiome(const std::string& biome) // Throw an error if the
     H_LOG(logger, Logger::DEBUG) << "Deleting biome '" << biome << "'." << std::endl;
 
     std::string errmsg = "Biome '" + biome + "' not found in `biome_list`.";
-    std::vector<std::string>::const_iterator i_biome = std::find(biome_list.begin(), biome_list.end(), biome);
-    H_ASSERT(has_biome( biome ), errmsg);
-
-    // Erase all values associated with the biome:
-    // Parameters
-    beta.erase( biome );
-    q10_rh.erase(biome);
-    warmingfactor.erase( biome );
-    f_nppv.erase(biome);
-    f_nppd.erase(biome);
-    f_litterd.erase(biome);
-
-    // C pools
-    veg_c.erase( biome );
-    remove_biome_from_ts(veg_c_tv, biome);
-    detritus_c.erase( biome );
-    remove_biome_from_ts(detritus_c_tv, biome);
-    soil_c.erase( biome );
-    remove_biome_from_ts(soil_c_tv, biome);
-
-    // Others
-    npp_flux0.erase( biome );
-    tempfertd.erase( biome );
-    remove_biome_from_ts( tempfertd_tv, biome );
-    tempferts.erase( biome );
-    remove_biome_from_ts( tempferts_tv, biome );
-    co2fert.erase( biome );
-
-    // Remove from `biome_list`
-    biome_list.erase( i_biome );
+    const int i = biome_index( biome );
+    H_ASSERT(i >= 0, errmsg);
+
+    // Remove from `biome_list` and erase all values associated with
+    // the biome. Its history slot is freed for the next biome created;
+    // the values already recorded there are never read again.
+    erase_biome_data( i );
 
     H_LOG(logger, Logger::DEBUG) << "Finished deleting biome '" << biome << ",." << std::endl;
 
 }
 
-// Create a new biome called `newname`, transfer all of the parameters
-// and pools from `oldname`, and delete `oldname`. Note that the new
-// biome will be at the end of the `biome_list`.
+// Rename biome `oldname` to `newname`.  Because all biome data are
+// indexed by position or history slot, this only changes the entry in
+// `biome_list`; the biome keeps its place in the list.
 void SimpleNbox::renameBiome(const std::string& oldname, const std::string& newname)
 {
     H_LOG(logger, Logger::DEBUG) << "Renaming biome '" << oldname <<
         "' to '" << newname << "'." << std::endl;
 
     std::string errmsg = "Biome '" + oldname + "' not found in `biome_list`.";
-    H_ASSERT(has_biome( oldname ), errmsg);
+    const int i = biome_index( oldname );
+    H_ASSERT(i >= 0, errmsg);
     errmsg = "Biome '" + newname + "' already exists in `biome_list`.";
     H_ASSERT(!has_biome( newname ), errmsg);
 
-    beta[ newname ] = beta.at( oldname );
-    beta.erase(oldname);
-    q10_rh[ newname ] = q10_rh.at( oldname );
-    q10_rh.erase(oldname);
-    warmingfactor[ newname ] = warmingfactor.at( oldname );
-    warmingfactor.erase( oldname );
-    f_nppv[ newname ] = f_nppv.at( oldname );
-    f_nppv.erase(oldname);
-    f_nppd[ newname ] = f_nppd.at( oldname );
-    f_nppd.erase(oldname);
-    f_litterd[ newname ] = f_litterd.at( oldname );
-    f_litterd.erase(oldname);
-
-    H_LOG(logger, Logger::DEBUG) << "Transferring C from biome '" << oldname <<
-        "' to '" << newname << "'." << std::endl;
-
-    // Transfer all C from `oldname` to `newname`
-    veg_c[ newname ] = veg_c.at( oldname );
-    veg_c.erase(oldname);
-    rename_biome_in_ts(veg_c_tv, oldname, newname);
-    detritus_c[ newname ] = detritus_c.at( oldname );
-    detritus_c.erase(oldname);
-    rename_biome_in_ts(detritus_c_tv, oldname, newname);
-    soil_c[ newname ] = soil_c.at( oldname );
-    soil_c.erase(oldname);
-    rename_biome_in_ts(soil_c_tv, oldname, newname);
-
-    npp_flux0[ newname ] = npp_flux0.at( oldname );
-    npp_flux0.erase(oldname);
-
-    co2fert[ newname ] = co2fert[ oldname ];
-    co2fert.erase( oldname );
-
-    tempfertd[ newname ] = tempfertd[ oldname ];
-    tempfertd.erase(oldname);
-    tempferts[ newname ] = tempferts[ oldname ];
-    tempferts.erase(oldname);
-
-    biome_list.push_back(newname);
-    biome_list.erase(std::find(biome_list.begin(), biome_list.end(), oldname));
+    biome_list[ i ] = newname;
+    biome_pos.erase( oldname );
+    biome_pos[ newname ] = i;
 
     H_LOG(logger, Logger::DEBUG) << "Done renaming biome '" << oldname <<
         "' to '" << newname << "'." << std::endl;
@@ -110,7 +110,30 @@ void slrComponent::prepareToRun() {
 
 //------------------------------------------------------------------------------
 
-tseries<double> tgav_vals;
+/*! \brief first derivative of the recorded temperature at a date
+ *
+ * Equivalent to the derivative of a linear interpolation of tgav at one of
+ * its (annual) nodes: the slope of the adjacent segment at either end of the
+ * record, and the mean of the two adjacent slopes in between.  Only the
+ * neighbouring years are needed, so this costs the same every year of a run.
+ */
+double slrComponent::tgav_deriv( const double date ) const {
+
+    const bool has_prev = tgav.exists( date-1 );
+    const bool has_next = tgav.exists( date+1 );
+    const double T = tgav.get( date ).value( U_DEGC );
+
+    if( has_prev && has_next ) {
+        const double slopePrev = T - tgav.get( date-1 ).value( U_DEGC );
+        const double slopeNext = tgav.get( date+1 ).value( U_DEGC ) - T;
+        return ( slopePrev + slopeNext ) / 2.0;
+    }
+    if( has_next )
+        return tgav.get( date+1 ).value( U_DEGC ) - T;
+    if( has_prev )
+        return T - tgav.get( date-1 ).value( U_DEGC );
+    return 0.0;
+}
 
 //------------------------------------------------------------------------------
 /*! \brief compute sea-level rise
@@ -125,11 +148,7 @@ void slrComponent::compute_slr( const double date ) {
     // First need to compute dTdt, the first derivative of the temperature curve
     double dTdt_double = 0.0;
     if( tgav.size() > 2 ) {
-        for( int i=tgav.firstdate(); i<=tgav.lastdate(); i++ ) {
-            tgav_vals.set( i, tgav.get( i ).value( U_DEGC ) );
-        }
-        tgav_vals.allowInterp( true );		// deriv needs a continuous function
-        dTdt_double = tgav_vals.get_deriv( date );
+        dTdt_double = tgav_deriv( date );
     }
 
     // These values and formula below are from:
@@ -15,11 +15,20 @@
 // some boost headers generate warnings under clang; not our problem, ignore
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Weverything"
+#include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 #pragma clang diagnostic pop
 
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <limits>
+#include <map>
+#include <mutex>
+#include <sstream>
 
 // The MinGW C++ compiler doesn't seem to pull in the cmath constants? (see #384)
 // As a workaround, we define M_PI here if needed
@@ -173,6 +182,9 @@ void TemperatureComponent::setData( const string& varName,
         } else if( varName == D_TGAV_CONSTRAIN ) {
             H_ASSERT( data.date != Core::undefinedIndex(), "date required" );
             tgav_constrain.set(data.date, data.getUnitval(U_DEGC));
+        } else if( varName == D_TEMP_PATTERN ) {
+            H_ASSERT( data.date == Core::undefinedIndex(), "date not allowed" );
+            read_pattern( data.value_str, data.file_contents );
         } else {
             H_THROW( "Unknown variable name while parsing " + getComponentName() + ": "
                     + varName );
@@ -185,6 +197,187 @@ void TemperatureComponent::setData( const string& varName,
     }
 }
 
+//------------------------------------------------------------------------------
+/*! \brief Diffusion kernel and the sum-of-exponentials fit of its tail
+ *
+ *  The kernel is the analytical solution to the integral in the temperature
+ *  difference equation, evaluated for every lag a run of ns steps can see.
+ *
+ *  For lags j >= nnear we approximate Ker[ns-1-j] by sum_k w_k r_k^(j-nnear),
+ *  with decay factors r_k = exp(-1/tau_k) on a geometric grid of time scales
+ *  and weights w_k from a least-squares fit (Householder QR) weighted by the
+ *  inverse kernel, i.e. minimizing relative error.  The kernel itself is a sum
+ *  of nearly cancelling terms, so it carries a rounding error that grows with
+ *  lag (up to ~1e-6 relative for millennial runs), and the fit cannot do
+ *  better than that.  If the fit misses tail_tol anywhere, or the run is too
+ *  short for a tail to matter, the memory term is summed directly.
+ */
+struct TemperatureComponent::Kernel {
+    Kernel( const int ns, const double taubot );
+
+    std::vector<double> Ker;            //!< kernel, indexed by ns-1-lag
+    bool use_tail;                      //!< is the tail fit in use? (else sum all lags directly)
+    double tail_error;                  //!< max relative error of the tail fit (0 if not attempted)
+    std::vector<double> tail_decay;     //!< one-step decay factor of each exponential
+    std::vector<double> tail_weight;    //!< weight of each exponential
+};
+
+TemperatureComponent::Kernel::Kernel( const int ns, const double taubot ) :
+    Ker( ns ), use_tail( false ), tail_error( 0.0 )
+{
+    const double tail_tol = 1.0e-5;     // max relative error allowed in the kernel tail fit
+
+    std::vector<double> KT0(ns, 0.0);
+    std::vector<double> KTA1(ns, 0.0);
+    std::vector<double> KTB1(ns, 0.0);
+    std::vector<double> KTA2(ns, 0.0);
+    std::vector<double> KTB2(ns, 0.0);
+    std::vector<double> KTA3(ns, 0.0);
+    std::vector<double> KTB3(ns, 0.0);
+
+    // Components of the analytical solution to the integral found in the temperature difference equation
+    // Third order bottom correction terms will be "more than sufficient" for simulations out to 2500
+    // (Equation A.25, EK05, or 2.3.23, TK07)
+
+    // First order
+    KT0[ns-1] = 4.0 - 2.0 * pow(2.0, 0.5);
+    KTA1[ns-1] = -8.0 * exp(-taubot / double(dt)) + 4.0 * pow(2.0, 0.5) * exp(-0.5 * taubot / double(dt));
+    KTB1[ns-1] = 4.0 * pow((M_PI * taubot / double(dt)), 0.5) * (1.0 + erf(pow(0.5 * taubot / double(dt), 0.5)) - 2.0 * erf(pow(taubot / double(dt), 0.5)));
+
+    // Second order
+    KTA2[ns-1] =  8.0 * exp(-4.0 * taubot / double(dt)) - 4.0 * pow(2.0, 0.5) * exp(-2.0 * taubot / double(dt));
+    KTB2[ns-1] = -8.0 * pow((M_PI * taubot / double(dt)), 0.5) * (1.0 + erf(pow((2.0 * taubot / double(dt)), 0.5)) - 2.0 * erf(2.0 * pow((taubot / double(dt)), 0.5)) );
+
+    // Third order
+    KTA3[ns-1] = -8.0 * exp(-9.0 * taubot / double(dt)) + 4.0 * pow(2.0, 0.5) * exp(-4.5 * taubot / double(dt));
+    KTB3[ns-1] = 12.0 * pow((M_PI * taubot / double(dt)), 0.5) * (1.0 + erf(pow((4.5 * taubot / double(dt)), 0.5)) - 2.0 * erf(3.0 * pow((taubot / double(dt)), 0.5)) );
+
+    // Calculate the kernel component vectors
+    for(int i=0; i<(ns-1); i++) {
+
+        // First order
+        KT0[i] = 4.0 * pow((double(ns-i)), 0.5) - 2.0 * pow((double(ns+1-i)), 0.5) - 2.0 * pow(double(ns-1-i), 0.5);
+        KTA1[i] = -8.0 * pow(double(ns-i), 0.5) * exp(-taubot / double(dt) / double(ns-i)) + 4.0 * pow(double(ns+1-i), 0.5) * exp(-taubot / double(dt) / double(ns+1-i)) + 4.0 * pow(double(ns-1-i), 0.5) * exp(-taubot/double(dt) / double(ns-1-i));
+        KTB1[i] =  4.0 * pow((M_PI * taubot / double(dt)), 0.5) * ( erf(pow((taubot / double(dt) / double(ns-1-i)), 0.5)) + erf(pow((taubot / double(dt) / double(ns+1-i)), 0.5)) - 2.0 * erf(pow((taubot / double(dt) / double(ns-i)), 0.5)) );
+
+        // Second order
+        KTA2[i] =  8.0 * pow(double(ns-i), 0.5) * exp(-4.0 * taubot / double(dt) / double(ns-i)) - 4.0 * pow(double(ns+1-i), 0.5) * exp(-4.0 * taubot / double(dt) / double(ns+1-i)) - 4.0 * pow(double(ns-1-i), 0.5) * exp(-4.0 * taubot / double(dt) / double(ns-1-i));
+        KTB2[i] = -8.0 * pow((M_PI * taubot / double(dt)), 0.5) * ( erf(2.0 * pow((taubot / double(dt) / double(ns-1-i)), 0.5)) + erf(2.0 * pow((taubot / double(dt) / double(ns+1-i)), 0.5)) - 2.0 * erf(2.0 * pow((taubot / double(dt) / double(ns-i)), 0.5)) );
+
+        // Third order
+        KTA3[i] = -8.0 * pow(double(ns-i), 0.5) * exp(-9.0 * taubot / double(dt) / double(ns-i)) + 4.0 * pow(double(ns+1-i), 0.5) * exp(-9.0 * taubot / double(dt) / double(ns+1-i)) + 4.0 * pow(double(ns-1-i), 0.5) * exp(-9.0 * taubot / double(dt) / double(ns-1-i));
+        KTB3[i] = 12.0 * pow((M_PI * taubot / double(dt)), 0.5) * ( erf(3.0 * pow((taubot / double(dt) / double(ns-1-i)), 0.5)) + erf(3.0 * pow((taubot / double(dt) / double(ns+1-i)), 0.5)) - 2.0 * erf(3.0 * pow((taubot / double(dt) / double(ns-i)), 0.5)) );
+    }
+
+    // Sum up the kernel components
+    for(int i=0; i<ns; i++) {
+
+        Ker[i] = KT0[i] + KTA1[i] + KTB1[i] + KTA2[i] + KTB2[i] + KTA3[i] + KTB3[i];
+
+    }
+
+    const int nrow = ns - nnear;          // lags nnear .. ns-1
+    if( nrow < 4 * ntail ) {
+        return;     // run too short for a tail to matter
+    }
+    for( int j = nnear; j < ns; j++ ) {
+        if( !( Ker[ns-1-j] > 0.0 ) ) {
+            return;
+        }
+    }
+
+    // Time scales from a few years out to several run lengths
+    const double tau_min = 4.0;
+    const double tau_max = 4.0 * double( ns );
+    std::vector<double> tau( ntail );
+    tail_decay.resize( ntail );
+    for( int k = 0; k < ntail; k++ ) {
+        tau[k] = tau_min * pow( tau_max / tau_min, double( k ) / double( ntail - 1 ) );
+        tail_decay[k] = exp( -double( dt ) / tau[k] );
+    }
+
+    // Design matrix (column-major) and right-hand side, rows scaled by 1/Ker
+    std::vector<double> M( nrow * ntail );
+    std::vector<double> rhs( nrow, 1.0 );
+    for( int r = 0; r < nrow; r++ ) {
+        const double ker = Ker[ns-1-nnear-r];
+        for( int k = 0; k < ntail; k++ ) {
+            M[k*nrow + r] = exp( -double( r * dt ) / tau[k] ) / ker;
+        }
+    }
+
+    // Householder QR, applied to the right-hand side as we go
+    std::vector<double> v( nrow );
+    for( int k = 0; k < ntail; k++ ) {
+        double norm = 0.0;
+        for( int r = k; r < nrow; r++ ) norm += M[k*nrow + r] * M[k*nrow + r];
+        norm = sqrt( norm );
+        const double alpha = M[k*nrow + k] > 0.0 ? -norm : norm;
+        double vnorm = 0.0;
+        for( int r = k; r < nrow; r++ ) {
+            v[r] = M[k*nrow + r] - ( r == k ? alpha : 0.0 );
+            vnorm += v[r] * v[r];
+        }
+        if( vnorm == 0.0 ) continue;
+        for( int c = k; c < ntail; c++ ) {
+            double dot = 0.0;
+            for( int r = k; r < nrow; r++ ) dot += v[r] * M[c*nrow + r];
+            dot = 2.0 * dot / vnorm;
+            for( int r = k; r < nrow; r++ ) M[c*nrow + r] -= dot * v[r];
+        }
+        double dot = 0.0;
+        for( int r = k; r < nrow; r++ ) dot += v[r] * rhs[r];
+        dot = 2.0 * dot / vnorm;
+        for( int r = k; r < nrow; r++ ) rhs[r] -= dot * v[r];
+    }
+    tail_weight.resize( ntail );
+    for( int k = ntail-1; k >= 0; k-- ) {
+        double w = rhs[k];
+        for( int c = k+1; c < ntail; c++ ) w -= M[c*nrow + k] * tail_weight[c];
+        tail_weight[k] = w / M[k*nrow + k];
+    }
+
+    // Check the fit against the kernel at every lag it will be used for
+    double maxerr = 0.0;
+    for( int r = 0; r < nrow; r++ ) {
+        double fit = 0.0;
+        for( int k = 0; k < ntail; k++ ) fit += tail_weight[k] * exp( -double( r * dt ) / tau[k] );
+        const double err = fabs( fit / Ker[ns-1-nnear-r] - 1.0 );
+        if( !( err <= maxerr ) ) maxerr = err;    // also catches NaN
+    }
+    tail_error = maxerr;
+    use_tail = ( maxerr <= tail_tol );
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Look up (or build) the diffusion kernel for a run length and taubot
+ *
+ *  Kernels are cached for the life of the process and shared read-only
+ *  between cores, so that parameter sweeps that leave diff alone skip the
+ *  precomputation.  The cache is guarded by a mutex so that cores can be
+ *  built from several threads.  To bound its size over long sweeps of diff
+ *  it is cleared when full; cores keep their own reference.
+ */
+std::shared_ptr<const TemperatureComponent::Kernel> TemperatureComponent::get_kernel( const int ns, const double taubot )
+{
+    static std::mutex cache_mutex;
+    static std::map<std::pair<int, double>, std::shared_ptr<const Kernel> > cache;
+    const std::size_t max_cached = 64;
+
+    std::lock_guard<std::mutex> lock( cache_mutex );
+    const std::pair<int, double> key( ns, taubot );
+    std::map<std::pair<int, double>, std::shared_ptr<const Kernel> >::const_iterator it = cache.find( key );
+    if( it != cache.end() ) {
+        return it->second;
+    }
+    if( cache.size() >= max_cached ) {
+        cache.clear();
+    }
+    std::shared_ptr<const Kernel> k( new Kernel( ns, taubot ) );
+    cache[ key ] = k;
+    return k;
+}
+
 //------------------------------------------------------------------------------
 // documentation is inherited
 // TO DO: should we put these in the ini file instead?
@@ -200,16 +393,6 @@ void TemperatureComponent::prepareToRun() {
     // Initializing all model components that depend on the number of timesteps (ns)
     ns = core->getEndDate() - core->getStartDate() + 1;
 
-    KT0 = std::vector<double>(ns, 0.0);
-    KTA1 = std::vector<double>(ns, 0.0);
-    KTB1 = std::vector<double>(ns, 0.0);
-    KTA2 = std::vector<double>(ns, 0.0);
-    KTB2 = std::vector<double>(ns, 0.0);
-    KTA3 = std::vector<double>(ns, 0.0);
-    KTB3 = std::vector<double>(ns, 0.0);
-
-    Ker.resize(ns);
-
     temp.resize(ns);
     temp_landair.resize(ns);
     temp_sst.resize(ns);
@@ -218,6 +401,7 @@ void TemperatureComponent::prepareToRun() {
     heat_mixed.resize(ns);
     heat_interior.resize(ns);
     forcing.resize(ns);
+    dpast.resize(ns);
 
     for(int i=0; i<3; i++) {
         B[i] = 0.0;
@@ -240,46 +424,15 @@ void TemperatureComponent::prepareToRun() {
     tauksl  = (1.0 - flnd) * cas / kls;                                  // sea-land heat exchange time scale, yr
     taukls  = flnd * cal / kls;                                          // land-sea heat exchange time scale, yr
 
-    // Components of the analytical solution to the integral found in the temperature difference equation
-    // Third order bottom correction terms will be "more than sufficient" for simulations out to 2500
-    // (Equation A.25, EK05, or 2.3.23, TK07)
-
-    // First order
-    KT0[ns-1] = 4.0 - 2.0 * pow(2.0, 0.5);
-    KTA1[ns-1] = -8.0 * exp(-taubot / double(dt)) + 4.0 * pow(2.0, 0.5) * exp(-0.5 * taubot / double(dt));
-    KTB1[ns-1] = 4.0 * pow((M_PI * taubot / double(dt)), 0.5) * (1.0 + erf(pow(0.5 * taubot / double(dt), 0.5)) - 2.0 * erf(pow(taubot / double(dt), 0.5)));
-
-    // Second order
-    KTA2[ns-1] =  8.0 * exp(-4.0 * taubot / double(dt)) - 4.0 * pow(2.0, 0.5) * exp(-2.0 * taubot / double(dt));
-    KTB2[ns-1] = -8.0 * pow((M_PI * taubot / double(dt)), 0.5) * (1.0 + erf(pow((2.0 * taubot / double(dt)), 0.5)) - 2.0 * erf(2.0 * pow((taubot / double(dt)), 0.5)) );
-
-    // Third order
-    KTA3[ns-1] = -8.0 * exp(-9.0 * taubot / double(dt)) + 4.0 * pow(2.0, 0.5) * exp(-4.5 * taubot / double(dt));
-    KTB3[ns-1] = 12.0 * pow((M_PI * taubot / double(dt)), 0.5) * (1.0 + erf(pow((4.5 * taubot / double(dt)), 0.5)) - 2.0 * erf(3.0 * pow((taubot / double(dt)), 0.5)) );
-
-    // Calculate the kernel component vectors
-    for(int i=0; i<(ns-1); i++) {
-
-        // First order
-        KT0[i] = 4.0 * pow((double(ns-i)), 0.5) - 2.0 * pow((double(ns+1-i)), 0.5) - 2.0 * pow(double(ns-1-i), 0.5);
-        KTA1[i] = -8.0 * pow(double(ns-i), 0.5) * exp(-taubot / double(dt) / double(ns-i)) + 4.0 * pow(double(ns+1-i), 0.5) * exp(-taubot / double(dt) / double(ns+1-i)) + 4.0 * pow(double(ns-1-i), 0.5) * exp(-taubot/double(dt) / double(ns-1-i));
-        KTB1[i] =  4.0 * pow((M_PI * taubot / double(dt)), 0.5) * ( erf(pow((taubot / double(dt) / double(ns-1-i)), 0.5)) + erf(pow((taubot / double(dt) / double(ns+1-i)), 0.5)) - 2.0 * erf(pow((taubot / double(dt) / double(ns-i)), 0.5)) );
-
-        // Second order
-        KTA2[i] =  8.0 * pow(double(ns-i), 0.5) * exp(-4.0 * taubot / double(dt) / double(ns-i)) - 4.0 * pow(double(ns+1-i), 0.5) * exp(-4.0 * taubot / double(dt) / double(ns+1-i)) - 4.0 * pow(double(ns-1-i), 0.5) * exp(-4.0 * taubot / double(dt) / double(ns-1-i));
-        KTB2[i] = -8.0 * pow((M_PI * taubot / double(dt)), 0.5) * ( erf(2.0 * pow((taubot / double(dt) / double(ns-1-i)), 0.5)) + erf(2.0 * pow((taubot / double(dt) / double(ns+1-i)), 0.5)) - 2.0 * erf(2.0 * pow((taubot / double(dt) / double(ns-i)), 0.5)) );
-
-        // Third order
-        KTA3[i] = -8.0 * pow(double(ns-i), 0.5) * exp(-9.0 * taubot / double(dt) / double(ns-i)) + 4.0 * pow(double(ns+1-i), 0.5) * exp(-9.0 * taubot / double(dt) / double(ns+1-i)) + 4.0 * pow(double(ns-1-i), 0.5) * exp(-9.0 * taubot / double(dt) / double(ns-1-i));
-        KTB3[i] = 12.0 * pow((M_PI * taubot / double(dt)), 0.5) * ( erf(3.0 * pow((taubot / double(dt) / double(ns-1-i)), 0.5)) + erf(3.0 * pow((taubot / double(dt) / double(ns+1-i)), 0.5)) - 2.0 * erf(3.0 * pow((taubot / double(dt) / double(ns-i)), 0.5)) );
-    }
-
-    // Sum up the kernel components
-    for(int i=0; i<ns; i++) {
-
-        Ker[i] = KT0[i] + KTA1[i] + KTB1[i] + KTA2[i] + KTB2[i] + KTA3[i] + KTB3[i];
-
+    // The diffusion kernel depends only on ns and taubot, so it is shared
+    // with every other core that has the same run length and diffusivity
+    kernel = get_kernel( ns, taubot );
+    if( kernel->use_tail ) {
+        H_LOG( logger, Logger::DEBUG ) << "Kernel tail fit: " << ntail << " exponentials, max relative error " << kernel->tail_error << std::endl;
+    } else if( kernel->tail_error > 0.0 ) {
+        H_LOG( logger, Logger::WARNING ) << "Kernel tail fit error " << kernel->tail_error << " too large; summing directly" << std::endl;
     }
+    const std::vector<double>& Ker = kernel->Ker;
 
     // Correction terms, remove oscillation artefacts due to short-term forcings
     // (Equation 2.3.27, TK07)
@@ -311,6 +464,79 @@ void TemperatureComponent::prepareToRun() {
 
     // Calculate the inverse of B
     invert_1d_2x2_matrix(B, IB);
+
+    tail_state.assign( ntail, 0.0 );
+    tail_tstep = -1;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Make room for timestep tstep
+ *
+ *  The core allows a run to continue past the configured end date.  When it
+ *  does, the state arrays and the kernel are grown geometrically, so that
+ *  extending a run incrementally costs amortized constant time per step
+ *  and never requires a re-prepare.
+ */
+void TemperatureComponent::extend_horizon(int tstep) {
+    if( tstep < ns ) {
+        return;
+    }
+    ns = std::max( tstep + 1, 2 * ns );
+    H_LOG( logger, Logger::NOTICE ) << "Extending temperature horizon to " << ns << " timesteps" << std::endl;
+
+    temp.resize(ns);
+    temp_landair.resize(ns);
+    temp_sst.resize(ns);
+    heatflux_mixed.resize(ns);
+    heatflux_interior.resize(ns);
+    heat_mixed.resize(ns);
+    heat_interior.resize(ns);
+    forcing.resize(ns);
+    dpast.resize(ns);
+
+    // The kernel is indexed from the end of the horizon, and its tail fit
+    // covers the whole horizon, so both are replaced and the exponential
+    // partial sums are rebuilt on the next step.
+    kernel = get_kernel( ns, taubot );
+    tail_tstep = -1;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Diffusion memory term sum_{j>=1} temp_sst[tstep-j] * Ker[ns-1-j]
+ *
+ *  The exponential partial sums are advanced one step per call.  If the
+ *  previous call was not for tstep-1 (first step, or after a reset) they are
+ *  rebuilt from the stored temperature history.
+ */
+double TemperatureComponent::memory_sum(int tstep) {
+    const std::vector<double>& Ker = kernel->Ker;
+    const bool use_tail = kernel->use_tail;
+    const std::vector<double>& tail_decay = kernel->tail_decay;
+    const std::vector<double>& tail_weight = kernel->tail_weight;
+    const int nlag = use_tail ? std::min( tstep, nnear - 1 ) : tstep;
+    double sum = 0.0;
+    for( int i = tstep - nlag; i < tstep; i++ ) {
+        sum = sum + temp_sst[i] * Ker[ns-tstep+i-1];
+    }
+
+    if( use_tail ) {
+        if( tail_tstep != tstep - 1 ) {
+            tail_state.assign( ntail, 0.0 );
+            for( int s = nnear; s < tstep; s++ ) {
+                for( int k = 0; k < ntail; k++ ) {
+                    tail_state[k] = tail_decay[k] * tail_state[k] + temp_sst[s-nnear];
+                }
+            }
+        }
+        if( tstep >= nnear ) {
+            for( int k = 0; k < ntail; k++ ) {
+                tail_state[k] = tail_decay[k] * tail_state[k] + temp_sst[tstep-nnear];
+                sum = sum + tail_weight[k] * tail_state[k];
+            }
+        }
+        tail_tstep = tstep;
+    }
+    return sum;
 }
 
 
@@ -340,6 +566,7 @@ void TemperatureComponent::run( const double runToDate ) {
 
     // Some needed inputs
     int tstep = runToDate - core->getStartDate();
+    extend_horizon(tstep);
     double aero_forcing =
         double(core->sendMessage( M_GETDATA, D_RF_BC ).value( U_W_M2 )) + double(core->sendMessage( M_GETDATA, D_RF_OC).value( U_W_M2 )) +
         double(core->sendMessage( M_GETDATA, D_RF_SO2d ).value( U_W_M2 )) + double(core->sendMessage( M_GETDATA, D_RF_SO2i ).value( U_W_M2 ));
@@ -371,8 +598,8 @@ void TemperatureComponent::run( const double runToDate ) {
     heatflux_interior[tstep] = 0.0;
 
     // Assume land and ocean forcings are equal to global forcing
-    std::vector<double> QL = forcing;
-    std::vector<double> QO = forcing;
+    const std::vector<double>& QL = forcing;
+    const std::vector<double>& QO = forcing;
 
     if (tstep > 0) {
 
@@ -396,10 +623,8 @@ void TemperatureComponent::run( const double runToDate ) {
 
         // ---------- SOLVE MODEL ------------------
         // Calculate temperatures
-        for(int i = 0; i <= tstep; i++) {
-            DPAST2 = DPAST2 + temp_sst[i] * Ker[ns-tstep+i-1];
-        }
-        DPAST2 = DPAST2 * fso * pow((double(dt)/taudif), 0.5);
+        dpast[tstep] = memory_sum(tstep);
+        DPAST2 = dpast[tstep] * fso * pow((double(dt)/taudif), 0.5);
 
         DTEAUX1 = A[0] * temp_landair[tstep-1] + A[1] * temp_sst[tstep-1];
         DTEAUX2 = A[2] * temp_landair[tstep-1] + A[3] * temp_sst[tstep-1];
@@ -410,6 +635,7 @@ void TemperatureComponent::run( const double runToDate ) {
     else {  // Handle the initial conditions
         temp_landair[0] = 0.0;
         temp_sst[0] = 0.0;
+        dpast[0] = 0.0;
     }
     temp[tstep] = flnd * temp_landair[tstep] + (1.0 - flnd) * bsi * temp_sst[tstep];
 
@@ -419,9 +645,8 @@ void TemperatureComponent::run( const double runToDate ) {
     // ------------------------------------------------------------------------
     if (tstep > 0) {
         heatflux_mixed[tstep] = cas*(temp_sst[tstep] - temp_sst[tstep-1]);
-        for (int i=0; i < tstep; i++) {
-            heatflux_interior[tstep] = heatflux_interior[tstep] + temp_sst[i]*Ker[ns-tstep+i];
-        }
+        // The memory sum one step back, plus the newest term
+        heatflux_interior[tstep] = dpast[tstep-1] + temp_sst[tstep-1]*kernel->Ker[ns-1];
         heatflux_interior[tstep] = cas*fso/pow((taudif*dt), 0.5)*(2.0*temp_sst[tstep] - heatflux_interior[tstep]);
         heat_mixed[tstep] = heat_mixed[tstep-1] + heatflux_mixed[tstep] * (powtoheat*dt);
         heat_interior[tstep] = heat_interior[tstep-1] + heatflux_interior[tstep] * (fso*powtoheat*dt);
@@ -551,6 +776,127 @@ void TemperatureComponent::setoutputs(int tstep)
     tgav_sst.set(temp_sst[tstep], U_DEGC, 0.0);
     temp_oceanair = bsi * temp_sst[tstep];
     tgav_oceanair.set(temp_oceanair, U_DEGC, 0.0);
+
+    scale_pattern();
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Load a temperature pattern
+ *  \param fileName  pattern file, either CSV or binary
+ *  \param contents  contents of the file, if not to be read from disk
+ *
+ *  The CSV form has a header naming the columns `lat`, `lon`, `slope`, and
+ *  `intercept` (in any order), then one row per grid cell.  Lines starting
+ *  with `#` or `;` are comments.
+ *
+ *  Large grids load much faster from the binary form: the four bytes `HPAT`,
+ *  the number of cells as a 32-bit integer, then the lat, lon, slope, and
+ *  intercept of every cell as blocks of 32-bit floats, all in native byte
+ *  order.  The magic number tells the two forms apart.
+ */
+void TemperatureComponent::read_pattern( const string& fileName,
+                                         const shared_ptr<const string>& contents )
+{
+    ifstream file;
+    istringstream embedded;
+    if( contents ) {
+        embedded.str( *contents );
+    } else {
+        file.open( fileName.c_str(), ios::binary );
+        H_ASSERT( file.is_open(), "Could not open temperature pattern: " + fileName );
+    }
+    istream& in = contents ? static_cast<istream&>( embedded ) : file;
+
+    vector<float> *columns[] = { &pattern_lat, &pattern_lon, &pattern_slope, &pattern_intercept };
+    const int ncol = 4;
+
+    char magic[ 4 ] = { 0, 0, 0, 0 };
+    in.read( magic, 4 );
+    if( in.gcount() == 4 && memcmp( magic, "HPAT", 4 ) == 0 ) {
+        int32_t ncell = 0;
+        in.read( reinterpret_cast<char*>( &ncell ), sizeof ncell );
+        H_ASSERT( in && ncell > 0, "Bad cell count in temperature pattern: " + fileName );
+        for( int col = 0; col < ncol; col++ ) {
+            columns[ col ]->resize( ncell );
+            in.read( reinterpret_cast<char*>( columns[ col ]->data() ), ncell * sizeof( float ) );
+        }
+        H_ASSERT( in, "Temperature pattern is truncated: " + fileName );
+    } else {
+        in.clear();
+        in.seekg( 0 );
+        for( int col = 0; col < ncol; col++ ) {
+            columns[ col ]->clear();
+        }
+
+        string line;
+        int lineNum = 0;
+        vector<int> order;      // pattern column of each file column
+        while( getline( in, line ) ) {
+            ++lineNum;
+            const size_t first = line.find_first_not_of( " \t\r" );
+            if( first == string::npos || line[ first ] == '#' || line[ first ] == ';' ) {
+                continue;
+            }
+            ostringstream where;
+            where << fileName << ":" << lineNum << ": ";
+
+            if( order.empty() ) {
+                // header row
+                vector<string> names;
+                boost::split( names, line, boost::is_any_of( "," ) );
+                for( size_t i = 0; i < names.size(); i++ ) {
+                    boost::trim( names[ i ] );
+                    const string& name = names[ i ];
+                    int col = -1;
+                    if( name == "lat" ) col = 0;
+                    else if( name == "lon" ) col = 1;
+                    else if( name == "slope" ) col = 2;
+                    else if( name == "intercept" ) col = 3;
+                    H_ASSERT( col >= 0, where.str() + "unknown pattern column '" + name + "'" );
+                    H_ASSERT( find( order.begin(), order.end(), col ) == order.end(),
+                              where.str() + "duplicate pattern column '" + name + "'" );
+                    order.push_back( col );
+                }
+                H_ASSERT( int( order.size() ) == ncol, where.str() + "pattern needs lat, lon, slope, and intercept columns" );
+                continue;
+            }
+
+            // data row; parse in place, since large grids have many of them
+            const char *str = line.c_str();
+            for( int i = 0; i < ncol; i++ ) {
+                char *end;
+                const double value = strtod( str, &end );
+                while( *end == ' ' || *end == '\t' || *end == '\r' ) end++;
+                H_ASSERT( end != str && *end == ( i < ncol - 1 ? ',' : '\0' ),
+                          where.str() + "could not parse pattern row" );
+                columns[ order[ i ] ]->push_back( value );
+                str = end + 1;
+            }
+        }
+        H_ASSERT( !pattern_slope.empty(), "Temperature pattern " + fileName + " has no cells" );
+    }
+
+    gridded_temp.assign( pattern_slope.size(), 0.0f );
+    H_LOG( logger, Logger::NOTICE ) << "Read " << pattern_slope.size() << " pattern cells from " << fileName << std::endl;
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Scale the temperature pattern by the current global temperature
+ *
+ *  This streams through the whole grid once per step, so it is written as a
+ *  plain loop over contiguous arrays that the compiler can vectorize.
+ */
+void TemperatureComponent::scale_pattern()
+{
+    const size_t ncell = gridded_temp.size();
+    const float t = tgav.value( U_DEGC );
+    const float *slope = pattern_slope.data();
+    const float *intercept = pattern_intercept.data();
+    float *out = gridded_temp.data();
+
+    for( size_t i = 0; i < ncell; i++ ) {
+        out[ i ] = slope[ i ] * t + intercept[ i ];
+    }
 }
 
 }
@@ -12,6 +12,7 @@
  *
  */
 
+#include <cmath>
 #include <fstream>
 #include <errno.h>
 #include <iostream>
@@ -216,6 +217,22 @@ TEST_F(TestCSVTableReader, CanReRead) {
     ASSERT_EQ( check.valueResult, 6 );
 }
 
+TEST_F(TestCSVTableReader, SeesSameSizeRewrite) {
+    testFile << "Date," << testVarName << std::endl;
+    testFile << "2,6" << std::endl;
+    testFile.close();
+    ASSERT_NO_THROW(reader.process(&core, testComponentName, testVarName));
+    // rewritten straight away, so the file's times may not change
+    std::ofstream rewrite( TestCSVTableReaderEnv::testFileName.c_str(), std::ios::trunc );
+    rewrite << "Date," << testVarName << std::endl;
+    rewrite << "2,7" << std::endl;
+    rewrite.close();
+    ASSERT_NO_THROW(reader.process(&core, testComponentName, testVarName));
+    CheckDummyVisitor check( 2 );
+    core.accept( &check );
+    ASSERT_EQ( check.valueResult, 7 );
+}
+
 TEST_F(TestCSVTableReader, CanMixNewlineHeader) {
     testFile << "Date," << testVarName << "\r\n";
     testFile << "2,6\n";
@@ -257,3 +274,23 @@ TEST_F(TestCSVTableReader, CanIgnoreExtralineCR) {
     core.accept( &check );
     ASSERT_EQ( check.valueResult, 6 );
 }
+
+TEST_F(TestCSVTableReader, NamedRows) {
+    testFile << "; land cells" << std::endl;
+    testFile << "cell," << testVarName << ",Other" << std::endl;
+    testFile << "UNITS,Pg C," << std::endl;
+    testFile << " boreal ,6,1" << std::endl;
+    testFile << "tropical,,2" << std::endl;
+    testFile.close();
+    std::vector<std::string> names = reader.getRowNames();
+    ASSERT_EQ( 2, names.size() );
+    EXPECT_EQ( "boreal", names[ 0 ] );
+    EXPECT_EQ( "tropical", names[ 1 ] );
+    EXPECT_EQ( "Other", reader.getColumnNames()[ 1 ] );
+    std::vector<unitval> values = reader.getValues( testVarName );
+    ASSERT_EQ( 2, values.size() );
+    EXPECT_EQ( 6, values[ 0 ].value( U_PGC ) );
+    EXPECT_TRUE( std::isnan( values[ 1 ].value( U_PGC ) ) );
+    // the names are not dates, so the table can't be read as a time series
+    ASSERT_THROW(reader.process(&core, testComponentName, testVarName), h_exception);
+}
@@ -0,0 +1,71 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  test_output_subscription.cpp
+ *  hector
+ *
+ */
+
+#include <gtest/gtest.h>
+
+#include "output_subscription.hpp"
+
+using namespace Hector;
+
+class TestOutputSubscription : public testing::Test {
+    // google test fixtures must be protected
+protected:
+    OutputSubscription subscription;
+};
+
+TEST_F(TestOutputSubscription, EverythingByDefault) {
+    EXPECT_FALSE( subscription.isSet() );
+    EXPECT_TRUE( subscription.forComponent( "temperature" ).any() );
+    EXPECT_TRUE( subscription.forComponent( "temperature" )( "Tgav" ) );
+
+    subscription.set( std::vector<std::string>() );
+    EXPECT_TRUE( subscription.isSet() );
+    EXPECT_TRUE( subscription.forComponent( "ocean" )( "pH_HL" ) );
+}
+
+TEST_F(TestOutputSubscription, ParseList) {
+    std::vector<std::string> vars = OutputSubscription::parse( " Tgav, Ca\tocean ,," );
+    ASSERT_EQ( 3, vars.size() );
+    EXPECT_EQ( "Tgav", vars[ 0 ] );
+    EXPECT_EQ( "Ca", vars[ 1 ] );
+    EXPECT_EQ( "ocean", vars[ 2 ] );
+    EXPECT_TRUE( OutputSubscription::parse( "" ).empty() );
+}
+
+TEST_F(TestOutputSubscription, MatchEntries) {
+    subscription.set( OutputSubscription::parse( "ocean, temperature.Tgav, simpleNbox.boreal.npp, Ca" ) );
+
+    // a component name subscribes all of its variables
+    EXPECT_TRUE( subscription.forComponent( "ocean" )( "pH_HL" ) );
+
+    // qualified names only match their component
+    EXPECT_TRUE( subscription.forComponent( "temperature" )( "Tgav" ) );
+    EXPECT_FALSE( subscription.forComponent( "temperature" )( "heatflux" ) );
+    EXPECT_FALSE( subscription.forComponent( "simpleNbox" )( "Tgav" ) );
+
+    // the component is everything before the first dot
+    EXPECT_TRUE( subscription.forComponent( "simpleNbox" )( "boreal.npp" ) );
+    EXPECT_FALSE( subscription.forComponent( "simpleNbox" )( "npp" ) );
+
+    // unqualified names match any component
+    EXPECT_TRUE( subscription.forComponent( "simpleNbox" )( "Ca" ) );
+    EXPECT_TRUE( subscription.forComponent( "CH4" )( "Ca" ) );
+}
+
+TEST_F(TestOutputSubscription, SkipComponents) {
+    // only qualified names tell which components are not wanted
+    subscription.set( OutputSubscription::parse( "temperature.Tgav, ocean.pH_HL" ) );
+    EXPECT_TRUE( subscription.forComponent( "temperature" ).any() );
+    EXPECT_TRUE( subscription.forComponent( "ocean" ).any() );
+    EXPECT_FALSE( subscription.forComponent( "simpleNbox" ).any() );
+    EXPECT_FALSE( subscription.forComponent( "CH4" ).any() );
+}
@@ -102,6 +102,11 @@ TEST_F(TestRestart, All) {
         from2000.addVisitor( &from2000Visitor );
         from2000.run();
         
+        // the visitors write in the background; wait for all of their output
+        fullVisitor.flush();
+        to2000Visitor.flush();
+        from2000Visitor.flush();
+
         // combine latter two runs to compare to the full
         to2000Output << from2000Output.rdbuf();
         EXPECT_EQ( fullOutput.str(), to2000Output.str() );
@@ -0,0 +1,105 @@
+/* Hector -- A Simple Climate Model
+   Copyright (C) 2014-2015  Battelle Memorial Institute
+
+   Please see the accompanying file LICENSE.md for additional licensing
+   information.
+*/
+/*
+ *  wide_csv_output_visitor.cpp
+ *  hector
+ *
+ */
+
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "h_exception.hpp"
+#include "csv_outputstream_visitor.hpp"
+#include "wide_csv_output_visitor.hpp"
+
+namespace Hector {
+
+using namespace std;
+
+//------------------------------------------------------------------------------
+/*! \brief Constructor
+ *  \param fileName The file to write the table to.
+ *  \param precision Significant digits of output values.
+ */
+WideCSVOutputVisitor::WideCSVOutputVisitor( const string& fileName, int precision )
+: RecordingOutputVisitor( fileName ), precision( precision )
+{
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Destructor
+ *
+ *  Nothing is written unless close was called.
+ */
+WideCSVOutputVisitor::~WideCSVOutputVisitor() {
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Append a header field, quoted if it would otherwise break the row
+ */
+static void append_field( string& buf, const string& field ) {
+    if( field.find_first_of( ",\"\n" ) == string::npos ) {
+        buf += field;
+        return;
+    }
+    buf += '"';
+    for( string::const_iterator it = field.begin(); it != field.end(); ++it ) {
+        if( *it == '"' ) buf += '"';
+        buf += *it;
+    }
+    buf += '"';
+}
+
+//------------------------------------------------------------------------------
+/*! \brief Write the recorded results as a table
+ *  \exception h_exception If the file could not be written.
+ */
+void WideCSVOutputVisitor::write() {
+    const size_t nvar = components.size();
+
+    string buf( "year" );
+    for( size_t i = 0; i < nvar; ++i ) {
+        buf += DELIMITER;
+        append_field( buf, components[ i ] + "." + names[ i ] + "[" + units[ i ] + "]" );
+    }
+    buf += '\n';
+
+    ofstream out( fileName.c_str(), ios::out | ios::trunc );
+    char num[ 32 ];
+    for( size_t r = 0; r < records.size(); ++r ) {
+        if( spinup[ r ] ) continue;
+
+        buf.append( num, snprintf( num, sizeof( num ), "%.17g", dates[ r ] ) );
+        const vector<double>& rec = records[ r ];
+        for( size_t i = 0; i < nvar; ++i ) {
+            buf += DELIMITER;
+            // variables added later, and values not written this year, are missing
+            if( i < rec.size() && !std::isnan( rec[ i ] ) ) {
+                buf.append( num, snprintf( num, sizeof( num ), "%.*g", precision, rec[ i ] ) );
+            } else {
+                buf += "NA";
+            }
+        }
+        buf += '\n';
+
+        if( buf.size() >= 256 * 1024 ) {
+            out.write( buf.data(), buf.size() );
+            buf.clear();
+        }
+    }
+    out.write( buf.data(), buf.size() );
+    out.close();
+    if( !out ) {
+        H_THROW( "Could not write wide csv output file " + fileName + " error: " + strerror( errno ) );
+    }
+}
+
+}
@@ -65,4 +65,11 @@ rm $INPUT/hector_rcp45_ftot.ini
 #$HECTOR input/hector_rcp45_ocean.ini
 #rm input/hector_rcp45_ocean.ini
 
+# Wide csv output, with and without a variable subscription; missing
+# values are written as NA, never as empty cells
+$HECTOR --wide $INPUT/hector_rcp45.ini
+if grep -q ',,\|,$' output/outputstream_rcp45_wide.csv; then exit 1; fi
+$HECTOR --wide --vars Tgav,simpleNbox.Ca $INPUT/hector_rcp45.ini
+head -1 output/outputstream_rcp45_wide.csv | grep -q '^year,simpleNbox.Ca\[ppmv CO2\],temperature.Tgav\[degC\]$'
+
 echo "All done."